@@ -0,0 +1,80 @@
+#include <hive/precomp.h>
+#include <hive/core/log.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+// Compares the throughput of ConsoleLogger against the previous iostream based implementation.
+// Redirect stdout (e.g. > /dev/null) so the terminal does not dominate the measurement; results go to stderr.
+namespace
+{
+    hive::LogCategory LogBench{"Bench", &hive::LogHiveRoot};
+
+    // ConsoleLogger as it was before batching: map lookup per message and std::endl after every line
+    class LegacyConsoleLogger
+    {
+    public:
+        explicit LegacyConsoleLogger(hive::LogManager &manager) : m_Manager(manager),
+            m_LoggerId(m_Manager.RegisterLogger<&LegacyConsoleLogger::Log>(this))
+        {
+        }
+
+        ~LegacyConsoleLogger()
+        {
+            m_Manager.UnregisterLogger(m_LoggerId);
+        }
+
+        void Log(const hive::LogRecord &record)
+        {
+            static std::unordered_map<hive::LogSeverity, const char *> labels = {
+                {hive::LogSeverity::TRACE, "[TRACE]"},
+                {hive::LogSeverity::INFO, "[INFO]"},
+                {hive::LogSeverity::WARN, "[WARN]"},
+                {hive::LogSeverity::ERROR, "[ERROR]"}
+            };
+
+            std::cout << labels[record.severity] << " " << record.category.GetFullPath() << " - " << record.message
+                    << std::endl;
+        }
+
+    private:
+        hive::LogManager &m_Manager;
+        hive::LogManager::LoggerId m_LoggerId;
+    };
+
+    constexpr int MessageCount = 200000;
+
+    template<typename Logger, typename... ConfigArgs>
+    void Run(const char *name, hive::LogManager &manager, ConfigArgs &&... configArgs)
+    {
+        Logger logger{manager, std::forward<ConfigArgs>(configArgs)...};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < MessageCount; ++i)
+        {
+            hive::LogInfo(LogBench, "The quick brown fox jumps over the lazy dog");
+        }
+        manager.FlushLoggers();
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::fprintf(stderr, "%-24s %10.0f msg/s  %6.1f ns/msg\n", name, MessageCount / elapsed,
+                     elapsed * 1e9 / MessageCount);
+    }
+}
+
+int main()
+{
+    hive::LogManager manager;
+    hive::ServiceScope services;
+    services.Provide(manager);
+
+    Run<LegacyConsoleLogger>("legacy", manager);
+    Run<hive::ConsoleLogger>("batched", manager, hive::ConsoleLoggerConfig{});
+    Run<hive::ConsoleLogger>("batched+colors+time", manager,
+                             hive::ConsoleLoggerConfig{.useColors = true, .showTimestamp = true, .showLocation = true});
+
+    return 0;
+}
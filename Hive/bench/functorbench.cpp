@@ -0,0 +1,147 @@
+#include <hive/precomp.h>
+#include <hive/utils/delegate.h>
+#include <hive/utils/functor.h>
+#include <hive/utils/moveonlyfunctor.h>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+// Compares the call and construction costs of Delegate, Functor, MoveOnlyFunctor, std::function and, when the standard library
+// provides it, std::move_only_function.
+namespace
+{
+    constexpr int CallCount = 50000000;
+    constexpr int ConstructCount = 10000000;
+
+    struct Counter
+    {
+        int Add(int value)
+        {
+            total += value;
+            return total;
+        }
+
+        int total{0};
+    };
+
+    template<typename Fn>
+    void Measure(const char *name, int count, Fn &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-48s %6.2f ns\n", name, elapsed / count);
+    }
+
+    // Calls through a reference the optimizer cannot see through
+    template<typename F>
+    [[gnu::noinline]] int CallMany(const F &callable, int count)
+    {
+        int result = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            result += callable(i);
+        }
+        return result;
+    }
+
+    template<typename F, typename Make>
+    [[gnu::noinline]] int ConstructMany(int count, Make &&make)
+    {
+        int result = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            F callable = make(i);
+            F moved = std::move(callable);
+            result += moved(i);
+        }
+        return result;
+    }
+}
+
+int main()
+{
+    Counter counter;
+    volatile int sink = 0;
+
+    std::printf("call, member function bound to an object\n");
+    Measure("  hive::Delegate", CallCount, [&]
+    {
+        const auto delegate = hive::Delegate<int(int)>::Bind<&Counter::Add>(&counter);
+        sink = CallMany(delegate, CallCount);
+    });
+    Measure("  hive::Functor", CallCount, [&]
+    {
+        const hive::Functor<int, int> functor{&counter, &Counter::Add};
+        sink = CallMany(functor, CallCount);
+    });
+    Measure("  hive::MoveOnlyFunctor", CallCount, [&]
+    {
+        const hive::MoveOnlyFunctor<int(int)> functor{&counter, &Counter::Add};
+        sink = CallMany(functor, CallCount);
+    });
+    Measure("  std::function", CallCount, [&]
+    {
+        const std::function<int(int)> function{std::bind_front(&Counter::Add, &counter)};
+        sink = CallMany(function, CallCount);
+    });
+
+    std::printf("call, lambda capturing 24 bytes\n");
+    const auto makeLambda = [&counter](int seed)
+    {
+        return [&counter, a = seed, b = seed * 2](int value) { return counter.Add(value + a + b); };
+    };
+    Measure("  hive::MoveOnlyFunctor", CallCount, [&]
+    {
+        const hive::MoveOnlyFunctor<int(int)> functor{makeLambda(1)};
+        sink = CallMany(functor, CallCount);
+    });
+    Measure("  std::function", CallCount, [&]
+    {
+        const std::function<int(int)> function{makeLambda(1)};
+        sink = CallMany(function, CallCount);
+    });
+#if defined(__cpp_lib_move_only_function)
+    Measure("  std::move_only_function", CallCount, [&]
+    {
+        const std::move_only_function<int(int) const> function{makeLambda(1)};
+        sink = CallMany(function, CallCount);
+    });
+#endif
+
+    std::printf("construct + move + call + destroy, lambda capturing 24 bytes\n");
+    Measure("  hive::MoveOnlyFunctor", ConstructCount, [&]
+    {
+        sink = ConstructMany<hive::MoveOnlyFunctor<int(int)>>(ConstructCount, makeLambda);
+    });
+    Measure("  std::function", ConstructCount, [&]
+    {
+        sink = ConstructMany<std::function<int(int)>>(ConstructCount, makeLambda);
+    });
+#if defined(__cpp_lib_move_only_function)
+    Measure("  std::move_only_function", ConstructCount, [&]
+    {
+        sink = ConstructMany<std::move_only_function<int(int)>>(ConstructCount, makeLambda);
+    });
+#endif
+
+    std::printf("construct + move + call + destroy, lambda owning a unique_ptr\n");
+    const auto makeOwning = [](int seed)
+    {
+        return [owned = std::make_unique<int>(seed)](int value) { return *owned + value; };
+    };
+    Measure("  hive::MoveOnlyFunctor", ConstructCount, [&]
+    {
+        sink = ConstructMany<hive::MoveOnlyFunctor<int(int)>>(ConstructCount, makeOwning);
+    });
+#if defined(__cpp_lib_move_only_function)
+    Measure("  std::move_only_function", ConstructCount, [&]
+    {
+        sink = ConstructMany<std::move_only_function<int(int)>>(ConstructCount, makeOwning);
+    });
+#endif
+
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+#include <hive/precomp.h>
+#include <hive/core/filelogger.h>
+#include <hive/core/log.h>
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Measures the latency of HIVE_LOG_INFO (severity check, message formatting and LogManager::Log) and the sustained
+// throughput for 1..N producer threads across sink configurations. Usage: hive_logbench [maxThreads] [messagesPerThread]
+// The console sink writes to stdout, redirect it (e.g. > /dev/null) so the terminal is not what gets measured.
+// Results are printed on stderr.
+namespace
+{
+    hive::LogCategory LogBench{"Bench", &hive::LogHiveRoot};
+
+    using Clock = std::chrono::steady_clock;
+
+    enum class SinkSetup
+    {
+        NONE,
+        CONSOLE,
+        FILE,
+        ASYNC_FILE,
+    };
+
+    const char *GetSinkSetupName(SinkSetup setup)
+    {
+        switch (setup)
+        {
+            case SinkSetup::NONE: return "none";
+            case SinkSetup::CONSOLE: return "console";
+            case SinkSetup::FILE: return "file";
+            case SinkSetup::ASYNC_FILE: return "async+file";
+        }
+        return "";
+    }
+
+    struct BenchResult
+    {
+        double p50{0};
+        double p99{0};
+        double p999{0};
+        double max{0};
+        double messagesPerSecond{0};
+    };
+
+    double Percentile(const std::vector<std::uint32_t> &sorted, double fraction)
+    {
+        const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+        return sorted[index];
+    }
+
+    BenchResult Run(SinkSetup setup, unsigned int threadCount, std::size_t messagesPerThread)
+    {
+        hive::LogManager manager;
+        hive::ServiceScope services;
+        services.Provide(manager);
+
+        std::unique_ptr<hive::ConsoleLogger> console;
+        std::unique_ptr<hive::FileLogger> file;
+        switch (setup)
+        {
+            case SinkSetup::NONE:
+                break;
+            case SinkSetup::CONSOLE:
+                console = std::make_unique<hive::ConsoleLogger>(manager);
+                break;
+            case SinkSetup::ASYNC_FILE:
+                manager.StartAsync({.capacity = 8192, .overflowPolicy = hive::LogOverflowPolicy::BLOCK});
+                [[fallthrough]];
+            case SinkSetup::FILE:
+                file = std::make_unique<hive::FileLogger>(manager, hive::FileLoggerConfig{.basePath = "hive_logbench"});
+                break;
+        }
+
+        // Latencies are stored in nanoseconds, preallocated so the measurement loop does not allocate
+        std::vector<std::vector<std::uint32_t>> latencies(threadCount);
+        for (auto &samples : latencies)
+            samples.resize(messagesPerThread);
+
+        std::barrier startLine{static_cast<std::ptrdiff_t>(threadCount + 1)};
+        std::vector<std::thread> producers;
+        producers.reserve(threadCount);
+
+        for (unsigned int t = 0; t < threadCount; ++t)
+        {
+            producers.emplace_back([&, t]()
+            {
+                std::uint32_t *samples = latencies[t].data();
+
+                startLine.arrive_and_wait();
+                for (std::size_t i = 0; i < messagesPerThread; ++i)
+                {
+                    const auto begin = Clock::now();
+                    HIVE_LOG_INFO(LogBench, "The quick brown fox jumps over the lazy dog {}", i);
+                    const auto end = Clock::now();
+                    samples[i] = static_cast<std::uint32_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+                }
+                manager.FlushLoggers();
+            });
+        }
+
+        startLine.arrive_and_wait();
+        const auto start = Clock::now();
+        for (auto &producer : producers)
+            producer.join();
+        manager.Flush();
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (setup == SinkSetup::ASYNC_FILE)
+            manager.StopAsync();
+
+        std::vector<std::uint32_t> all;
+        all.reserve(threadCount * messagesPerThread);
+        for (const auto &samples : latencies)
+            all.insert(all.end(), samples.begin(), samples.end());
+        std::sort(all.begin(), all.end());
+
+        BenchResult result;
+        result.p50 = Percentile(all, 0.5);
+        result.p99 = Percentile(all, 0.99);
+        result.p999 = Percentile(all, 0.999);
+        result.max = all.back();
+        result.messagesPerSecond = static_cast<double>(all.size()) / elapsed;
+        return result;
+    }
+
+    double MeasureClockOverhead()
+    {
+        constexpr int Samples = 100000;
+        const auto start = Clock::now();
+        for (int i = 0; i < Samples; ++i)
+        {
+            [[maybe_unused]] const volatile auto now = Clock::now().time_since_epoch().count();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / Samples;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const long long threadArg = argc > 1 ? std::atoll(argv[1]) : std::min(hardwareThreads, 8u);
+    const long long messageArg = argc > 2 ? std::atoll(argv[2]) : 100000;
+    if (threadArg <= 0 || threadArg > 1024 || messageArg <= 0)
+    {
+        std::fprintf(stderr, "usage: %s [max threads 1..1024] [messages per thread > 0]\n", argv[0]);
+        return 1;
+    }
+    const auto maxThreads = static_cast<unsigned int>(threadArg);
+    const auto messagesPerThread = static_cast<std::size_t>(messageArg);
+
+    std::fprintf(stderr, "%zu messages per thread, clock overhead %.1f ns (included in latencies)\n\n",
+                 messagesPerThread, MeasureClockOverhead());
+    std::fprintf(stderr, "%-12s %7s %10s %10s %10s %10s %14s\n", "sinks", "threads", "p50 ns", "p99 ns", "p999 ns",
+                 "max ns", "msg/s");
+
+    for (const SinkSetup setup : {SinkSetup::NONE, SinkSetup::CONSOLE, SinkSetup::FILE, SinkSetup::ASYNC_FILE})
+    {
+        for (unsigned int threads = 1; threads <= maxThreads; threads = threads < maxThreads
+                                                                       ? std::min(threads * 2, maxThreads)
+                                                                       : threads + 1)
+        {
+            const BenchResult result = Run(setup, threads, messagesPerThread);
+            std::fprintf(stderr, "%-12s %7u %10.0f %10.0f %10.0f %10.0f %14.0f\n", GetSinkSetupName(setup), threads,
+                         result.p50, result.p99, result.p999, result.max, result.messagesPerSecond);
+        }
+    }
+
+    return 0;
+}
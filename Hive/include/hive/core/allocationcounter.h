@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+namespace hive
+{
+    // Number of operator new calls made by the calling thread. Only counted when Hive is built with
+    // hive_track_allocations, which replaces the global operator new and delete; otherwise always 0.
+    [[nodiscard]] std::uint64_t GetThreadAllocationCount();
+
+    [[nodiscard]] bool IsAllocationTrackingEnabled();
+}
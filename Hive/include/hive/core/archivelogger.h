@@ -0,0 +1,98 @@
+#pragma once
+
+#include <hive/core/log.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hive
+{
+    struct ArchiveLoggerConfig
+    {
+        const char *basePath{"hive"}; //Segments are <basePath>.<n>.hla, with their block index in <basePath>.<n>.hli
+        std::size_t blockSize{64 * 1024}; //Uncompressed bytes per block
+        std::size_t segmentSize{64 * 1024 * 1024}; //Compressed bytes after which the next segment is started
+        unsigned int maxSegments{0}; //The oldest segments are deleted past this count, 0 keeps them all
+        std::chrono::milliseconds maxBlockAge{0}; //A block not full yet is written once this old, 0 waits until full
+        LoggerConfig logger{.delivery = LogDelivery::DEDICATED}; //Compression stays off the logging threads
+    };
+
+    // Long term storage: lines are accumulated into blocks that are compressed (see blockcompression.h) and appended
+    // to the current segment, so writes stay sequential. Each block is also recorded in the segment's index file
+    // with the time range of its lines, which lets hive_logarchive seek by time and only decompress what it prints.
+    // Lines still in the current block are written on Flush, which LogManager::Flush triggers, and on destruction.
+    // Writer batches do not end a block: small blocks would compress worse than the text they replace.
+    class ArchiveLogger
+    {
+    public:
+        static constexpr std::uint32_t BlockMagic = 0x4B4C4248; //"HBLK"
+
+        // Precedes every compressed block in a segment
+        struct BlockHeader
+        {
+            std::uint32_t magic;
+            std::uint32_t rawSize;
+            std::uint32_t compressedSize;
+            std::uint32_t lineCount;
+            std::uint64_t firstTimestamp; //Nanoseconds since the Unix epoch
+            std::uint64_t lastTimestamp;
+        };
+
+        // One per block, in the index file
+        struct IndexEntry
+        {
+            std::uint64_t firstTimestamp;
+            std::uint64_t lastTimestamp;
+            std::uint64_t offset; //Of the BlockHeader in the segment
+        };
+
+        explicit ArchiveLogger(LogManager &manager, const ArchiveLoggerConfig &config = {});
+
+        ~ArchiveLogger();
+
+        ArchiveLogger(const ArchiveLogger &other) = delete;
+        ArchiveLogger &operator=(const ArchiveLogger &other) = delete;
+
+        void Log(const LogRecord &record);
+
+        // Compresses and writes the current block even if it is not full
+        void Flush();
+
+    private:
+        // Called by the writer after each batch, only writes the block once it is older than maxBlockAge
+        void OnBatchWritten();
+
+        void WriteBlock();
+        bool OpenSegment();
+        void CloseSegment();
+        [[nodiscard]] std::string GetSegmentPath(unsigned int index, const char *extension) const;
+
+        LogManager &m_Manager; //the LogManager must have a longer lifetime than this ArchiveLogger
+        const std::string m_BasePath;
+        const std::size_t m_BlockSize;
+        const std::size_t m_SegmentSize;
+        const unsigned int m_MaxSegments;
+        const std::uint64_t m_MaxBlockAge; //Nanoseconds
+
+        std::mutex m_Mutex;
+        std::vector<std::byte> m_Block;
+        std::vector<std::byte> m_Compressed;
+        std::uint32_t m_LineCount{0};
+        std::uint64_t m_FirstTimestamp{0};
+        std::uint64_t m_LastTimestamp{0};
+
+        std::FILE *m_Segment{nullptr};
+        std::FILE *m_Index{nullptr};
+        std::uint64_t m_SegmentOffset{0};
+        unsigned int m_SegmentIndex{0};
+        unsigned int m_OldestSegmentIndex{0}; //Not pruned yet, may no longer exist
+
+        LogManager::LoggerId m_LoggerId;
+        EventSubscription m_FlushSubscription;
+    };
+}
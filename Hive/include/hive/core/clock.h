@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace hive
+{
+    // Reads the CPU timestamp counter: a few cycles and no syscall, unlike clock_gettime. Assumes an invariant
+    // counter (constant rate, synchronized across cores), which every x86-64 CPU of the last decade and the arm64
+    // generic timer provide. Other targets fall back to steady_clock nanoseconds.
+    [[nodiscard]] inline std::uint64_t ReadClockTicks()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        std::uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Ticks are converted using a rate measured against steady_clock (CLOCK_MONOTONIC). The measurement spans from
+    // static initialization to the first conversion, which waits if less than 20 ms have passed; call
+    // CalibrateClock during startup to pay that wait up front.
+    void CalibrateClock();
+
+    [[nodiscard]] std::uint64_t GetClockTicksPerSecond();
+
+    // Nanoseconds on the steady_clock timeline
+    [[nodiscard]] std::uint64_t ClockTicksToNanoseconds(std::uint64_t ticks);
+
+    // Nanoseconds since the Unix epoch
+    [[nodiscard]] std::uint64_t ClockTicksToWallNanoseconds(std::uint64_t ticks);
+}
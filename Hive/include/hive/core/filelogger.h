@@ -0,0 +1,58 @@
+#pragma once
+
+#include <hive/core/log.h>
+#include <hive/platform/mappedfile.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hive
+{
+    struct FileLoggerConfig
+    {
+        const char *basePath{"hive"}; //Segments are written to <basePath>.<index>.log
+        std::size_t segmentSize{16 * 1024 * 1024};
+        unsigned int maxSegments{4}; //Older segments are overwritten in a round robin
+        LoggerConfig logger{};
+    };
+
+    // Writes into a memory mapped, pre-sized segment file. Each message reserves its range with a single atomic
+    // add, so there is no syscall per message; when the segment is full the thread whose message crosses the end
+    // truncates it and maps the next one. The file is mapped shared, so what was written survives a crash.
+    class FileLogger
+    {
+    public:
+        explicit FileLogger(LogManager &manager, const FileLoggerConfig &config = {});
+
+        ~FileLogger();
+
+        FileLogger(const FileLogger &other) = delete;
+        FileLogger &operator=(const FileLogger &other) = delete;
+
+        void Log(const LogRecord &record);
+
+        [[nodiscard]] bool IsOpen() const { return m_Base.load(std::memory_order_acquire) != nullptr; }
+
+    private:
+        void Append(const char *data, std::size_t size);
+        void Rotate(std::size_t usedSize);
+        bool OpenSegment(unsigned int index);
+
+        LogManager &m_Manager; //the LogManager must have a longer lifetime than this FileLogger
+        const std::string m_BasePath;
+        const std::size_t m_SegmentSize;
+        const unsigned int m_MaxSegments;
+
+        MappedFile m_File;
+        unsigned int m_SegmentIndex{0};
+
+        std::atomic<std::byte *> m_Base{nullptr};
+        std::atomic<std::uint32_t> m_Generation{0};
+        alignas(64) std::atomic<std::uint64_t> m_Cursor{0};
+        alignas(64) std::atomic<std::uint64_t> m_Committed{0};
+
+        LogManager::LoggerId m_LoggerId;
+    };
+}
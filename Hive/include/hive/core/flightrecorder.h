@@ -0,0 +1,69 @@
+#pragma once
+
+#include <hive/core/log.h>
+#include <hive/platform/mappedfile.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace hive
+{
+    struct FlightRecorderConfig
+    {
+        const char *backingPath{nullptr}; //Map the rings to this file so they can be read even if the process is killed
+        const char *dumpPath{"hive_flightrecorder.log"}; //Written by the crash handler in addition to stderr
+        unsigned int maxThreads{32};
+        unsigned int recordsPerThread{512};
+        LogSeverity minSeverity{LogSeverity::TRACE};
+        bool installCrashHandler{true};
+    };
+
+    // Keeps the last records of every logging thread in fixed per-thread rings, regardless of the logger levels.
+    // Nothing is written out until a fatal signal, where the crash handler dumps the rings with async-signal-safe
+    // calls only. A thread gives its ring back when it exits; threads that find all maxThreads rings in use are not
+    // recorded, and their count is reported in the dump.
+    class FlightRecorder
+    {
+    public:
+        static constexpr std::size_t SlotSize = 256;
+
+        explicit FlightRecorder(const FlightRecorderConfig &config);
+        ~FlightRecorder();
+
+        FlightRecorder(const FlightRecorder &other) = delete;
+        FlightRecorder &operator=(const FlightRecorder &other) = delete;
+
+        [[nodiscard]] bool IsValid() const { return m_Region != nullptr; }
+        [[nodiscard]] LogSeverity GetMinSeverity() const { return m_MinSeverity; }
+
+        void Record(const LogRecord &record);
+
+        // Writes every ring, oldest record first. Async-signal-safe.
+        void Dump(int handle) const;
+
+    private:
+        struct RegionHeader;
+        struct Ring;
+        struct Slot;
+
+        static void OnCrash(int signal);
+
+        Ring *GetThreadRing();
+        [[nodiscard]] Ring *GetRing(unsigned int index) const;
+        [[nodiscard]] Slot *GetSlot(Ring *ring, std::uint64_t index) const;
+
+        const std::uint64_t m_Id;
+        const unsigned int m_MaxThreads;
+        const unsigned int m_RecordsPerThread;
+        const LogSeverity m_MinSeverity;
+        const std::string m_DumpPath;
+        bool m_HasCrashHandler{false};
+
+        MappedFile m_File;
+        std::unique_ptr<std::byte[]> m_Memory;
+        std::byte *m_Region{nullptr};
+    };
+}
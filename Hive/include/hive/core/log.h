@@ -1,108 +1,435 @@
 #pragma once
 
-#include <hive/utils/functor.h>
-#include <hive/utils/singleton.h>
+#include <hive/core/clock.h>
+#include <hive/core/logformat.h>
+#include <hive/utils/delegate.h>
+#include <hive/utils/event.h>
+#include <hive/utils/rcuvalue.h>
+#include <hive/utils/serviceregistry.h>
 
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <source_location>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 namespace hive
 {
+    enum class LogSeverity
+    {
+        TRACE, INFO, WARN, ERROR
+    };
+
+    [[nodiscard]] constexpr const char *GetSeverityName(LogSeverity severity)
+    {
+        constexpr std::array<const char *, 4> names = {"TRACE", "INFO", "WARN", "ERROR"};
+        return names[static_cast<std::size_t>(severity)];
+    }
+
+    // Categories are meant to be globals. The constructor only stores the name and the parent's address, so a
+    // category is constant initialized (constinit) whatever translation unit its parent lives in and costs nothing at
+    // startup. The first use registers it: its full path is composed into fixed storage and it gets a dense id that
+    // sinks and encoders can use to index per-category tables.
     class LogCategory
     {
     public:
-        constexpr explicit LogCategory(const char *name, LogCategory *parentCategory = nullptr) : m_Name(name),
+        static constexpr std::size_t MaxPathLength = 128; //Longer paths are truncated
+        static constexpr std::uint32_t InvalidId = ~std::uint32_t{0};
+
+        constexpr explicit LogCategory(const char *name, const LogCategory *parentCategory = nullptr) : m_Name(name),
             m_ParentCategory(parentCategory)
         {
-            if (m_ParentCategory)
-                m_FullPath = std::string(m_ParentCategory->GetFullPath()) + "/" + name;
-            else
-                m_FullPath = name;
         }
 
+        ~LogCategory();
+
         [[nodiscard]] constexpr const char *GetName() const { return m_Name; }
         [[nodiscard]] constexpr const LogCategory *GetParentCategory() const { return m_ParentCategory; }
-        [[nodiscard]] const std::string &GetFullPath() const { return m_FullPath; }
+
+        [[nodiscard]] std::string_view GetFullPath() const
+        {
+            EnsureRegistered();
+            return {m_FullPath, m_FullPathLength};
+        }
+
+        // In [0, GetLogCategoryCount()), stable for the lifetime of the category
+        [[nodiscard]] std::uint32_t GetId() const
+        {
+            EnsureRegistered();
+            return m_Id.load(std::memory_order_relaxed);
+        }
+
+        // Whether anything (loggers or the flight recorder) wants this severity. Checked before any work is done.
+        [[nodiscard]] bool IsEnabled(LogSeverity severity) const
+        {
+            const std::uint8_t minSeverity = m_MinSeverity.load(std::memory_order_relaxed);
+            if (minSeverity == UnregisteredSeverity) [[unlikely]]
+            {
+                Register();
+                return IsEnabled(severity);
+            }
+            return static_cast<std::uint8_t>(severity) >= minSeverity;
+        }
+
+        // Effective logger level, inherited from the closest configured parent (see logfilter.h)
+        [[nodiscard]] bool IsLoggerEnabled(LogSeverity severity) const
+        {
+            const std::uint8_t loggerSeverity = m_LoggerSeverity.load(std::memory_order_relaxed);
+            if (loggerSeverity == UnregisteredSeverity) [[unlikely]]
+            {
+                Register();
+                return IsLoggerEnabled(severity);
+            }
+            return static_cast<std::uint8_t>(severity) >= loggerSeverity;
+        }
 
         LogCategory(const LogCategory &other) = delete; //Copy constructor
         LogCategory(LogCategory &&other) = delete; //Move constructor
         LogCategory &operator=(const LogCategory &other) = delete; //Copy assignment
         LogCategory &operator=(LogCategory &&other) = delete; //Move assignment
     private:
+        friend class LogCategoryRegistry;
+
+        static constexpr std::uint8_t UnregisteredSeverity = 0xFF;
+
+        void EnsureRegistered() const
+        {
+            if (m_Id.load(std::memory_order_acquire) == InvalidId) [[unlikely]]
+                Register();
+        }
+
+        void Register() const;
+
         const char *m_Name;
-        std::string m_FullPath;
-        LogCategory *m_ParentCategory;
+        const LogCategory *m_ParentCategory;
+
+        // Filled once by the registry, before m_Id is published
+        mutable char m_FullPath[MaxPathLength]{};
+        mutable std::size_t m_FullPathLength{0};
+        mutable std::atomic<std::uint32_t> m_Id{InvalidId};
+
+        mutable std::atomic<std::uint8_t> m_MinSeverity{UnregisteredSeverity};
+        mutable std::atomic<std::uint8_t> m_LoggerSeverity{UnregisteredSeverity};
+        mutable const LogCategory *m_NextCategory{nullptr};
     };
 
+    // Number of ids handed out so far, ids of destroyed categories are not reused
+    [[nodiscard]] std::uint32_t GetLogCategoryCount();
+
     extern const LogCategory LogHiveRoot;
 
-    enum class LogSeverity
+    // What loggers receive. The message only lives for the duration of the callback.
+    struct LogRecord
     {
-        TRACE, INFO, WARN, ERROR
+        const LogCategory &category;
+        LogSeverity severity;
+        const char *message;
+        std::source_location location; //Empty for records that did not capture a call site
+        std::uint64_t timestamp{ReadClockTicks()}; //Taken where the record is built, see clock.h to convert it
+    };
+
+    enum class LogOverflowPolicy
+    {
+        DROP, //Discard the new message
+        BLOCK, //Wait for the writer thread to make room
+        OVERWRITE_OLDEST //Discard the oldest queued message
+    };
+
+    struct LogAsyncConfig
+    {
+        std::size_t capacity{8192}; //Number of records, rounded up to a power of two
+        LogOverflowPolicy overflowPolicy{LogOverflowPolicy::DROP};
+    };
+
+    struct LogAsyncStats
+    {
+        std::uint64_t written{0};
+        std::uint64_t dropped{0};
+        std::uint64_t overwritten{0};
+        std::uint64_t truncated{0};
+        std::uint64_t deferredDropped{0}; //Deferred records lost because a thread buffer was full
     };
 
-    class LogManager final : public Singleton<LogManager>
+    enum class LogDelivery
+    {
+        INLINE, //On the thread that logged, even when the LogManager is async
+        SHARED, //On the LogManager's async writer thread when it runs, inline otherwise
+        DEDICATED //On a thread owned by the logger, behind its own queue, so a slow logger stalls nobody else
+    };
+
+    struct LoggerConfig
+    {
+        LogSeverity minSeverity{LogSeverity::TRACE};
+        const LogCategory *category{nullptr}; //Only records of this category and its children, all when null
+        LogDelivery delivery{LogDelivery::SHARED};
+        LogAsyncConfig queue{}; //Queue of a DEDICATED logger
+    };
+
+    class AsyncLogWriter;
+    class BinaryLogFile;
+    class DeferredLogBuffer;
+    class FlightRecorder;
+    struct FlightRecorderConfig;
+
+    class LogManager final
     {
     public:
         using LoggerId = unsigned int;
-        using LogCallback = Functor<void, const LogCategory &, LogSeverity, const char *>;
+        using LogCallback = Delegate<void(const LogRecord &)>;
+        using FlushCallback = Delegate<void()>;
 
-        void UnregisterLogger(LoggerId id);
+        LogManager();
+        ~LogManager();
 
-        void Log(const LogCategory &cat, LogSeverity sev, const char *msg);
+        // Loggers can be registered and unregistered from any thread while others log. Both wait for in-flight
+        // dispatches to finish, so they must not be called from inside a logger callback.
+        // Usage: RegisterLogger<&MyLogger::Log>(this)
+        template<auto Method, typename T>
+        [[nodiscard]] LoggerId RegisterLogger(T *obj, const LoggerConfig &config = {})
+        {
+            return RegisterCallback(LogCallback::Bind<Method>(obj), {}, config);
+        }
 
-        template<typename T>
-        [[nodiscard]] LoggerId RegisterLogger(T *obj, void (T::*method)(const LogCategory &, LogSeverity, const char *))
+        // FlushMethod is called on the thread that delivered records, for loggers that batch their output
+        template<auto Method, auto FlushMethod, typename T>
+        [[nodiscard]] LoggerId RegisterLogger(T *obj, const LoggerConfig &config = {})
         {
-            // HIVE_ASSERT(m_Count + 1 < m_Loggers.size())
-            m_Loggers[m_Count++] = {m_Count, LogCallback{obj, method}};
-            return ++m_IdCount;
+            return RegisterCallback(LogCallback::Bind<Method>(obj), FlushCallback::Bind<FlushMethod>(obj), config);
         }
 
+        void UnregisterLogger(LoggerId id);
+
+        void Log(const LogRecord &record);
+
+        // In async mode Log only copies the message into a lock-free queue and a writer thread calls the loggers.
+        // Start/Stop must not race with other threads logging.
+        void StartAsync(const LogAsyncConfig &config = {});
+        void StopAsync();
+        [[nodiscard]] bool IsAsync() const { return m_AsyncWriter != nullptr; }
+
+        // Blocks until every message queued before the call, for the shared writer and the dedicated loggers, has been
+        // handed to the loggers, then broadcasts the flush event
+        void Flush();
+
+        // For loggers holding output back across batches, which write it out on an explicit Flush
+        Event<> &GetFlushEvent() { return m_FlushEvent; }
+
+        // Lets batching loggers write what the calling thread buffered. The writer threads do this after every batch;
+        // when logging synchronously call it once per frame.
+        void FlushLoggers();
+
+        [[nodiscard]] LogAsyncStats GetAsyncStats() const;
+
+        // Stats of the queue delivering to this logger: its own when DEDICATED, the shared writer's when SHARED
+        [[nodiscard]] LogAsyncStats GetLoggerStats(LoggerId id) const;
+
+        // Called after a deferred record was committed to the thread buffer. In async mode the writer thread picks it
+        // up, otherwise it is formatted right away on the calling thread.
+        void SubmitDeferred(DeferredLogBuffer &buffer);
+
+        // When set, deferred records are written raw to file for offline formatting instead of reaching the loggers
+        void SetBinaryLogFile(BinaryLogFile *file);
+
+        // Captures every record down to the recorder severity, even in categories whose logger level rejects it,
+        // and dumps them on a crash. Like StartAsync, must not race with other threads logging.
+        bool EnableFlightRecorder(const FlightRecorderConfig &config);
+        void DisableFlightRecorder();
+        [[nodiscard]] const FlightRecorder *GetFlightRecorder() const { return m_FlightRecorder.get(); }
+
     private:
-        std::array<std::pair<LoggerId, LogCallback>, 10> m_Loggers;
-        unsigned int m_Count = 0;
-        unsigned int m_IdCount = 0;
+        friend class AsyncLogWriter;
+
+        struct LoggerEntry
+        {
+            [[nodiscard]] bool Accepts(const LogRecord &record) const;
+
+            LoggerId id;
+            LogCallback callback;
+            FlushCallback flush;
+            LogSeverity minSeverity;
+            const LogCategory *category;
+            LogDelivery delivery;
+            std::shared_ptr<AsyncLogWriter> writer; //DEDICATED only, stopped when the last copy of the list lets go
+        };
+
+        enum class DispatchScope
+        {
+            ALL, //Call the inline and shared loggers, queue for the dedicated ones
+            PRODUCER, //Like ALL, except the shared loggers get the record through the async writer queue
+            SHARED_ONLY //Records coming out of the async writer queue
+        };
+
+        LoggerId RegisterCallback(const LogCallback &callback, const FlushCallback &flush, const LoggerConfig &config);
+        void Dispatch(const LogRecord &record, DispatchScope scope);
+        void DispatchShared(const LogRecord &record);
+        std::size_t DrainDeferred(DeferredLogBuffer &buffer);
+        std::size_t DrainDeferredBuffers();
+
+        RcuValue<std::vector<LoggerEntry>> m_Loggers;
+        std::atomic<LoggerId> m_IdCount{0};
+
+        std::unique_ptr<AsyncLogWriter> m_AsyncWriter;
+        std::unique_ptr<FlightRecorder> m_FlightRecorder;
+        BinaryLogFile *m_BinaryLogFile{nullptr};
+        Event<> m_FlushEvent;
     };
 
+    struct ConsoleLoggerConfig
+    {
+        bool useColors{false}; //ANSI colored severity labels
+        bool showTimestamp{false}; //UTC time of day the record was created, with microseconds
+        bool showLocation{false}; //file:line of the call site when the record has one
+        LoggerConfig logger{};
+    };
+
+    // Formats into a per-thread batch and writes it with a single call once the batch fills up, on ERROR, on
+    // LogManager::FlushLoggers (which the async writer calls after each batch) and when the thread exits.
+    // Formatting does no heap allocation.
     class ConsoleLogger
     {
     public:
-        explicit ConsoleLogger(LogManager &manager);
+        explicit ConsoleLogger(LogManager &manager, const ConsoleLoggerConfig &config = {});
 
         ~ConsoleLogger();
 
-        void Log(const LogCategory &category, LogSeverity severity, const char *message);
+        void Log(const LogRecord &record);
+
+        // Writes what the calling thread has batched
+        void Flush();
 
     private:
         LogManager &m_Manager; //the LogManager must have a longer lifetime than this ConsoleLogger
+        const ConsoleLoggerConfig m_Config;
         LogManager::LoggerId m_LoggerId;
     };
 
-    inline void LogGeneral(const LogCategory &cat, LogSeverity sev, const char *msg)
+    inline void LogGeneral(const LogCategory &cat, LogSeverity sev, const char *msg,
+                           const std::source_location &location = std::source_location::current())
+    {
+        if (!cat.IsEnabled(sev))
+            return;
+
+        GetService<LogManager>().Log({cat, sev, msg, location});
+    }
+
+    // Formats "{}" placeholders into a stack buffer, only once the category accepted the severity.
+    // Prefer the overloads taking a LogFormatString, this one does not check the format.
+    template<typename... Args>
+    void LogGeneral(const LogCategory &cat, LogSeverity sev, const std::source_location &location,
+                    std::string_view format, const Args &... args)
+    {
+        if (!cat.IsEnabled(sev))
+            return;
+
+        LogFormatBuffer buffer;
+        const auto appendArg = [&](LogFormatBuffer &out, std::size_t index)
+        {
+            std::size_t argIndex = 0;
+            ((argIndex++ == index ? AppendLogArg(out, args) : void()), ...);
+        };
+        FormatLogMessage(buffer, format, sizeof...(Args), appendArg);
+
+        GetService<LogManager>().Log({cat, sev, buffer.CStr(), location});
+    }
+
+    template<typename... Args>
+    void LogGeneral(const LogCategory &cat, LogSeverity sev, LogFormatString<Args...> format, const Args &... args)
+    {
+        LogGeneral(cat, sev, format.GetLocation(), format.Get(), args...);
+    }
+
+    inline void LogTrace(const LogCategory &category, const char *message,
+                         const std::source_location &location = std::source_location::current())
+    {
+        LogGeneral(category, LogSeverity::TRACE, message, location);
+    }
+
+    template<typename... Args>
+    void LogTrace(const LogCategory &category, LogFormatString<Args...> format, const Args &... args)
     {
-        // HIVE_ASSERT(LogManager::IsInitialized())
-        LogManager::GetInstance().Log(cat, sev, msg);
+        LogGeneral(category, LogSeverity::TRACE, format, args...);
     }
 
-    inline void LogTrace(const LogCategory &category, const char *message)
+    inline void LogInfo(const LogCategory &category, const char *message,
+                        const std::source_location &location = std::source_location::current())
     {
-        LogGeneral(category, LogSeverity::TRACE, message);
+        LogGeneral(category, LogSeverity::INFO, message, location);
     }
 
-    inline void LogInfo(const LogCategory &category, const char *message)
+    template<typename... Args>
+    void LogInfo(const LogCategory &category, LogFormatString<Args...> format, const Args &... args)
     {
-        LogGeneral(category, LogSeverity::INFO, message);
+        LogGeneral(category, LogSeverity::INFO, format, args...);
     }
 
-    inline void LogWarning(const LogCategory &category, const char *message)
+    inline void LogWarning(const LogCategory &category, const char *message,
+                           const std::source_location &location = std::source_location::current())
     {
-        LogGeneral(category, LogSeverity::WARN, message);
+        LogGeneral(category, LogSeverity::WARN, message, location);
     }
 
-    inline void LogError(const LogCategory &category, const char *message)
+    template<typename... Args>
+    void LogWarning(const LogCategory &category, LogFormatString<Args...> format, const Args &... args)
     {
-        LogGeneral(category, LogSeverity::ERROR, message);
+        LogGeneral(category, LogSeverity::WARN, format, args...);
+    }
+
+    inline void LogError(const LogCategory &category, const char *message,
+                         const std::source_location &location = std::source_location::current())
+    {
+        LogGeneral(category, LogSeverity::ERROR, message, location);
+    }
+
+    template<typename... Args>
+    void LogError(const LogCategory &category, LogFormatString<Args...> format, const Args &... args)
+    {
+        LogGeneral(category, LogSeverity::ERROR, format, args...);
     }
 }
+
+// Build-time severity floor for the HIVE_LOG_* macros. Calls below it expand to nothing, so their arguments are never
+// evaluated. Set through the hive_log_min_severity CMake cache variable; defaults to INFO when NDEBUG is defined.
+#define HIVE_LOG_LEVEL_TRACE 0
+#define HIVE_LOG_LEVEL_INFO 1
+#define HIVE_LOG_LEVEL_WARN 2
+#define HIVE_LOG_LEVEL_ERROR 3
+#define HIVE_LOG_LEVEL_OFF 4
+
+#if !defined(HIVE_LOG_MIN_SEVERITY)
+#if defined(NDEBUG)
+#define HIVE_LOG_MIN_SEVERITY HIVE_LOG_LEVEL_INFO
+#else
+#define HIVE_LOG_MIN_SEVERITY HIVE_LOG_LEVEL_TRACE
+#endif
+#endif
+
+#define HIVE_LOG_STRIPPED(...) do { } while (false)
+#define HIVE_LOG(cat, sev, format, ...) ::hive::LogGeneral(cat, sev, format __VA_OPT__(,) __VA_ARGS__)
+
+#if HIVE_LOG_MIN_SEVERITY <= HIVE_LOG_LEVEL_TRACE
+#define HIVE_LOG_TRACE(cat, format, ...) HIVE_LOG(cat, ::hive::LogSeverity::TRACE, format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define HIVE_LOG_TRACE(...) HIVE_LOG_STRIPPED()
+#endif
+
+#if HIVE_LOG_MIN_SEVERITY <= HIVE_LOG_LEVEL_INFO
+#define HIVE_LOG_INFO(cat, format, ...) HIVE_LOG(cat, ::hive::LogSeverity::INFO, format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define HIVE_LOG_INFO(...) HIVE_LOG_STRIPPED()
+#endif
+
+#if HIVE_LOG_MIN_SEVERITY <= HIVE_LOG_LEVEL_WARN
+#define HIVE_LOG_WARN(cat, format, ...) HIVE_LOG(cat, ::hive::LogSeverity::WARN, format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define HIVE_LOG_WARN(...) HIVE_LOG_STRIPPED()
+#endif
+
+#if HIVE_LOG_MIN_SEVERITY <= HIVE_LOG_LEVEL_ERROR
+#define HIVE_LOG_ERROR(cat, format, ...) HIVE_LOG(cat, ::hive::LogSeverity::ERROR, format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define HIVE_LOG_ERROR(...) HIVE_LOG_STRIPPED()
+#endif
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <hive/core/log.h>
+#include <hive/core/logformat.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace hive
+{
+    // Deferred logging: the call site only records the format string pointer, the category, the severity,
+    // a timestamp and the raw argument bytes. Formatting happens on the async writer thread, or offline
+    // when the records are written to a BinaryLogFile and read back with the hive_logdecode tool.
+
+    enum class LogArgType : std::uint8_t
+    {
+        BOOL, CHAR, INT, UINT, FLOAT, STRING, POINTER
+    };
+
+    struct DeferredLogEntry
+    {
+        std::uint32_t size; //Header plus encoded arguments, padded to EntryAlignment
+        std::uint8_t severity;
+        std::uint8_t argCount;
+        std::uint8_t isPadding;
+        std::uint8_t reserved;
+        const LogCategory *category;
+        const char *format;
+        std::uint64_t timestamp;
+        //Followed by argCount arguments, each a LogArgType tag and its payload
+    };
+
+    // Single producer / single consumer byte ring owned by one logging thread
+    class DeferredLogBuffer
+    {
+    public:
+        static constexpr std::size_t Capacity = 64 * 1024;
+        static constexpr std::size_t EntryAlignment = 8;
+
+        DeferredLogBuffer() : m_Data(std::make_unique<std::byte[]>(Capacity))
+        {
+        }
+
+        // Producer side. Returns nullptr when there is not enough free space
+        std::byte *Reserve(std::size_t size)
+        {
+            const std::size_t head = m_Head.load(std::memory_order_relaxed);
+            const std::size_t contiguous = Capacity - (head & (Capacity - 1));
+            const std::size_t padding = size > contiguous ? contiguous : 0;
+
+            if (size > Capacity || !HasSpace(head, size + padding))
+                return nullptr;
+
+            if (padding != 0)
+            {
+                //Mark the tail end of the ring as skipped so the entry stays contiguous
+                DeferredLogEntry marker{};
+                marker.size = static_cast<std::uint32_t>(padding);
+                marker.isPadding = 1;
+                std::memcpy(m_Data.get() + (head & (Capacity - 1)), &marker, offsetof(DeferredLogEntry, reserved));
+            }
+
+            m_PendingPadding = padding;
+            return m_Data.get() + ((head + padding) & (Capacity - 1));
+        }
+
+        void Commit(std::size_t size)
+        {
+            const std::size_t head = m_Head.load(std::memory_order_relaxed);
+            m_Head.store(head + m_PendingPadding + size, std::memory_order_release);
+        }
+
+        // Consumer side. fn receives each entry and a pointer to its argument bytes
+        template<typename Fn>
+        std::size_t Consume(Fn &&fn)
+        {
+            std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+            const std::size_t head = m_Head.load(std::memory_order_acquire);
+            std::size_t count = 0;
+
+            while (tail != head)
+            {
+                const std::byte *data = m_Data.get() + (tail & (Capacity - 1));
+
+                DeferredLogEntry entry;
+                std::memcpy(&entry, data, offsetof(DeferredLogEntry, reserved));
+                if (!entry.isPadding)
+                {
+                    std::memcpy(&entry, data, sizeof(DeferredLogEntry));
+                    fn(entry, data + sizeof(DeferredLogEntry));
+                    count++;
+                }
+
+                tail += entry.size;
+                m_Tail.store(tail, std::memory_order_release);
+            }
+
+            return count;
+        }
+
+        [[nodiscard]] std::size_t GetWritePosition() const { return m_Head.load(std::memory_order_acquire); }
+        [[nodiscard]] std::size_t GetReadPosition() const { return m_Tail.load(std::memory_order_acquire); }
+
+        [[nodiscard]] bool IsEmpty() const
+        {
+            return m_Tail.load(std::memory_order_acquire) == m_Head.load(std::memory_order_acquire);
+        }
+
+        void Abandon() { m_IsAbandoned.store(true, std::memory_order_release); }
+        [[nodiscard]] bool IsAbandoned() const { return m_IsAbandoned.load(std::memory_order_acquire); }
+
+        void CountDropped() { m_Dropped.fetch_add(1, std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+    private:
+        bool HasSpace(std::size_t head, std::size_t needed)
+        {
+            if (Capacity - (head - m_CachedTail) >= needed)
+                return true;
+
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            return Capacity - (head - m_CachedTail) >= needed;
+        }
+
+        std::unique_ptr<std::byte[]> m_Data;
+
+        alignas(64) std::atomic<std::size_t> m_Head{0};
+        std::size_t m_CachedTail{0};
+        std::size_t m_PendingPadding{0};
+        std::atomic<std::uint64_t> m_Dropped{0};
+
+        alignas(64) std::atomic<std::size_t> m_Tail{0};
+        std::atomic<bool> m_IsAbandoned{false};
+    };
+
+    // Every thread that logged through the deferred path, so the writer thread can drain them
+    class DeferredLogRegistry
+    {
+    public:
+        static DeferredLogRegistry &Get();
+
+        // Buffer of the calling thread, registered on first use and abandoned when the thread exits
+        static DeferredLogBuffer &GetThreadBuffer();
+
+        template<typename Fn>
+        void ForEach(Fn &&fn)
+        {
+            std::lock_guard lock(m_Mutex);
+            for (const auto &buffer : m_Buffers)
+            {
+                fn(*buffer);
+            }
+
+            const auto isReleasable = [this](const auto &buffer)
+            {
+                if (!buffer->IsAbandoned() || !buffer->IsEmpty())
+                    return false;
+
+                m_ReleasedDropped += buffer->GetDroppedCount();
+                return true;
+            };
+            std::erase_if(m_Buffers, isReleasable);
+        }
+
+        // Blocks until every entry committed before the call has been consumed
+        void WaitUntilDrained();
+
+        [[nodiscard]] std::uint64_t GetDroppedCount();
+
+    private:
+        std::shared_ptr<DeferredLogBuffer> Register();
+
+        std::mutex m_Mutex;
+        std::vector<std::shared_ptr<DeferredLogBuffer>> m_Buffers;
+        std::uint64_t m_ReleasedDropped{0};
+    };
+
+    // Formats the encoded arguments of an entry into buffer
+    void FormatDeferredMessage(LogFormatBuffer &buffer, std::string_view format, const std::byte *args, std::size_t argCount);
+
+    // Whether argCount encoded arguments fit in size bytes, for records read back from untrusted storage
+    [[nodiscard]] bool IsValidDeferredArgs(const std::byte *args, std::size_t size, std::size_t argCount);
+
+    // Writes raw deferred records plus a dictionary of format strings and category paths, each emitted once.
+    // Without an async writer every producer thread drains its own buffer, so writes are serialized to keep the
+    // dictionary consistent and each record contiguous in the file.
+    class BinaryLogFile
+    {
+    public:
+        static constexpr char Magic[8] = {'H', 'I', 'V', 'E', 'L', 'O', 'G', '1'};
+
+        enum class Tag : std::uint8_t
+        {
+            FORMAT = 'F', CATEGORY = 'C', MESSAGE = 'M'
+        };
+
+        BinaryLogFile() = default;
+        ~BinaryLogFile();
+
+        BinaryLogFile(const BinaryLogFile &other) = delete;
+        BinaryLogFile &operator=(const BinaryLogFile &other) = delete;
+
+        bool Open(const char *path);
+        void Close();
+        void Flush();
+
+        [[nodiscard]] bool IsOpen() const
+        {
+            std::lock_guard lock(m_Mutex);
+            return m_File != nullptr;
+        }
+
+        void Write(const DeferredLogEntry &entry, const std::byte *args);
+
+    private:
+        void WriteDefinition(Tag tag, std::uint64_t id, std::string_view text);
+
+        template<typename T>
+        void WriteValue(const T &value)
+        {
+            std::fwrite(&value, sizeof(T), 1, m_File);
+        }
+
+        mutable std::mutex m_Mutex;
+        std::FILE *m_File{nullptr};
+        std::unordered_set<const void *> m_KnownFormats;
+        std::vector<bool> m_KnownCategories; //Indexed by category id
+    };
+
+    namespace detail
+    {
+        inline constexpr std::size_t MaxDeferredStringSize = 512;
+
+        template<typename T>
+        constexpr LogArgType GetLogArgType()
+        {
+            using U = std::remove_cvref_t<T>;
+            if constexpr (std::is_same_v<U, bool>)
+                return LogArgType::BOOL;
+            else if constexpr (std::is_same_v<U, char>)
+                return LogArgType::CHAR;
+            else if constexpr (std::is_enum_v<U>)
+                return GetLogArgType<std::underlying_type_t<U>>();
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+                return LogArgType::INT;
+            else if constexpr (std::is_integral_v<U>)
+                return LogArgType::UINT;
+            else if constexpr (std::is_floating_point_v<U>)
+                return LogArgType::FLOAT;
+            else if constexpr (std::is_null_pointer_v<U>)
+                return LogArgType::POINTER;
+            else if constexpr (std::is_convertible_v<const U &, std::string_view>)
+                return LogArgType::STRING;
+            else if constexpr (std::is_pointer_v<U>)
+                return LogArgType::POINTER;
+            else
+                static_assert(sizeof(U) == 0, "Unsupported deferred log argument type");
+        }
+
+        template<typename T>
+        std::string_view ToDeferredString(const T &value)
+        {
+            if constexpr (std::is_pointer_v<T>)
+            {
+                if (value == nullptr)
+                    return "(null)";
+            }
+            const std::string_view view{value};
+            return view.substr(0, MaxDeferredStringSize);
+        }
+
+        template<typename T>
+        std::size_t GetEncodedSize(const T &value)
+        {
+            constexpr LogArgType type = GetLogArgType<T>();
+            if constexpr (type == LogArgType::BOOL || type == LogArgType::CHAR)
+                return 1 + 1;
+            else if constexpr (type == LogArgType::STRING)
+                return 1 + sizeof(std::uint32_t) + ToDeferredString(value).size();
+            else
+                return 1 + 8;
+        }
+
+        template<typename T>
+        std::byte *EncodeArg(std::byte *out, const T &value)
+        {
+            constexpr LogArgType type = GetLogArgType<T>();
+            *out++ = static_cast<std::byte>(type);
+
+            const auto write = [&out](const auto &payload)
+            {
+                std::memcpy(out, &payload, sizeof(payload));
+                out += sizeof(payload);
+            };
+
+            if constexpr (type == LogArgType::BOOL || type == LogArgType::CHAR)
+                write(static_cast<char>(value));
+            else if constexpr (type == LogArgType::INT)
+                write(static_cast<std::int64_t>(value));
+            else if constexpr (type == LogArgType::UINT)
+                write(static_cast<std::uint64_t>(value));
+            else if constexpr (type == LogArgType::FLOAT)
+                write(static_cast<double>(value));
+            else if constexpr (type == LogArgType::POINTER)
+                write(reinterpret_cast<std::uint64_t>(static_cast<const void *>(value)));
+            else
+            {
+                const std::string_view text = ToDeferredString(value);
+                write(static_cast<std::uint32_t>(text.size()));
+                std::memcpy(out, text.data(), text.size());
+                out += text.size();
+            }
+            return out;
+        }
+
+    }
+
+    // format must have static storage duration: only its address is recorded
+    template<std::size_t N, typename... Args>
+    void LogDeferred(const LogCategory &cat, LogSeverity sev, const char (&format)[N], const Args &... args)
+    {
+        static_assert(sizeof...(Args) <= 255, "Too many deferred log arguments");
+
+        if (!cat.IsEnabled(sev))
+            return;
+
+        constexpr std::size_t alignment = DeferredLogBuffer::EntryAlignment;
+        const std::size_t payloadSize = sizeof(DeferredLogEntry) + (std::size_t{0} + ... + detail::GetEncodedSize(args));
+        const std::size_t entrySize = (payloadSize + alignment - 1) & ~(alignment - 1);
+
+        DeferredLogBuffer &buffer = DeferredLogRegistry::GetThreadBuffer();
+        std::byte *out = buffer.Reserve(entrySize);
+        if (out == nullptr)
+        {
+            buffer.CountDropped();
+            return;
+        }
+
+        DeferredLogEntry entry{};
+        entry.size = static_cast<std::uint32_t>(entrySize);
+        entry.severity = static_cast<std::uint8_t>(sev);
+        entry.argCount = static_cast<std::uint8_t>(sizeof...(Args));
+        entry.category = &cat;
+        entry.format = format;
+        entry.timestamp = ReadClockTicks();
+        std::memcpy(out, &entry, sizeof(entry));
+
+        std::byte *cursor = out + sizeof(entry);
+        ((cursor = detail::EncodeArg(cursor, args)), ...);
+        std::memset(cursor, 0, out + entrySize - cursor);
+
+        buffer.Commit(entrySize);
+
+        GetService<LogManager>().SubmitDeferred(buffer);
+    }
+
+    template<std::size_t N, typename... Args>
+    void LogTraceDeferred(const LogCategory &category, const char (&format)[N], const Args &... args)
+    {
+        LogDeferred(category, LogSeverity::TRACE, format, args...);
+    }
+
+    template<std::size_t N, typename... Args>
+    void LogInfoDeferred(const LogCategory &category, const char (&format)[N], const Args &... args)
+    {
+        LogDeferred(category, LogSeverity::INFO, format, args...);
+    }
+
+    template<std::size_t N, typename... Args>
+    void LogWarningDeferred(const LogCategory &category, const char (&format)[N], const Args &... args)
+    {
+        LogDeferred(category, LogSeverity::WARN, format, args...);
+    }
+
+    template<std::size_t N, typename... Args>
+    void LogErrorDeferred(const LogCategory &category, const char (&format)[N], const Args &... args)
+    {
+        LogDeferred(category, LogSeverity::ERROR, format, args...);
+    }
+}
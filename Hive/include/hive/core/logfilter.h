@@ -0,0 +1,46 @@
+#pragma once
+
+#include <hive/core/log.h>
+
+#include <optional>
+#include <string_view>
+
+namespace hive
+{
+    // Per-category severity filtering. A level set on a category path ("Hive/Render") applies to that category and
+    // every child that has no level of its own. The result is cached in each LogCategory so rejecting a message is a
+    // single load and compare; changing the configuration recomputes the cache of all categories.
+    //
+    // Config format, one rule per line, '#' starts a comment:
+    //     default = INFO
+    //     Hive/Render = WARN
+    //     Testbed = TRACE
+    //     Hive/Audio = OFF
+    // Levels are TRACE, INFO, WARN, ERROR or OFF (case insensitive).
+
+    // Level used by categories without a configured ancestor. TRACE unless changed.
+    void SetDefaultLogLevel(LogSeverity severity);
+
+    void SetLogLevel(std::string_view categoryPath, LogSeverity severity);
+    void DisableLogCategory(std::string_view categoryPath);
+
+    // Makes the category inherit from its parent again
+    void ResetLogLevel(std::string_view categoryPath);
+    void ResetLogLevels();
+
+    // Lowest severity a consumer other than the loggers (the flight recorder) needs. Categories let those messages
+    // through to the LogManager, which still applies the logger levels before dispatching.
+    void SetLogCaptureLevel(std::optional<LogSeverity> severity);
+
+    // Rules that fail to parse are skipped, returns false if there was any
+    bool ApplyLogConfig(std::string_view config);
+    bool LoadLogConfig(const char *path);
+
+    namespace detail
+    {
+        // Minimum severity and category subtree (all when null) of a registered logger. A category also rejects what
+        // no logger accepts, so the LogManager adds and removes its loggers here as they come and go.
+        void AddLogSink(const LogCategory *category, LogSeverity minSeverity);
+        void RemoveLogSink(const LogCategory *category, LogSeverity minSeverity);
+    }
+}
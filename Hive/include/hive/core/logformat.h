@@ -0,0 +1,195 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <source_location>
+#include <string_view>
+#include <type_traits>
+
+namespace hive
+{
+    // Fixed-capacity text buffer used to format log messages without touching the heap.
+    // Output past the capacity is silently truncated.
+    class LogFormatBuffer
+    {
+    public:
+        static constexpr std::size_t Capacity = 1024;
+
+        void Clear() { m_Size = 0; m_Data[0] = '\0'; }
+
+        void Append(std::string_view text)
+        {
+            const std::size_t count = text.size() < Remaining() ? text.size() : Remaining();
+            std::memcpy(m_Data + m_Size, text.data(), count);
+            m_Size += count;
+            m_Data[m_Size] = '\0';
+        }
+
+        void Append(char c)
+        {
+            if (Remaining() == 0)
+                return;
+            m_Data[m_Size++] = c;
+            m_Data[m_Size] = '\0';
+        }
+
+        void Append(bool value) { Append(value ? std::string_view{"true"} : std::string_view{"false"}); }
+        void Append(std::int64_t value) { AppendChars(value); }
+        void Append(std::uint64_t value) { AppendChars(value); }
+        void Append(double value) { AppendChars(value); }
+
+        void Append(const void *pointer)
+        {
+            Append(std::string_view{"0x"});
+            AppendChars(reinterpret_cast<std::uintptr_t>(pointer), 16);
+        }
+
+        [[nodiscard]] const char *CStr() const { return m_Data; }
+        [[nodiscard]] std::string_view View() const { return {m_Data, m_Size}; }
+        [[nodiscard]] std::size_t Size() const { return m_Size; }
+
+    private:
+        [[nodiscard]] std::size_t Remaining() const { return Capacity - 1 - m_Size; }
+
+        template<typename T, typename... Options>
+        void AppendChars(T value, Options... options)
+        {
+            const auto result = std::to_chars(m_Data + m_Size, m_Data + Capacity - 1, value, options...);
+            if (result.ec == std::errc{})
+                m_Size = result.ptr - m_Data;
+            m_Data[m_Size] = '\0';
+        }
+
+        char m_Data[Capacity]{'\0'};
+        std::size_t m_Size{0};
+    };
+
+    // Walks a "{}" style format string, calling appendArg(buffer, index) for each placeholder.
+    // "{{" and "}}" produce literal braces. Placeholders without a matching argument are kept as-is.
+    template<typename AppendArgFn>
+    void FormatLogMessage(LogFormatBuffer &buffer, std::string_view format, std::size_t argCount, AppendArgFn &&appendArg)
+    {
+        std::size_t argIndex = 0;
+        std::size_t literalStart = 0;
+
+        for (std::size_t i = 0; i < format.size(); ++i)
+        {
+            const char c = format[i];
+            const bool hasNext = i + 1 < format.size();
+
+            if ((c == '{' || c == '}') && hasNext && format[i + 1] == c)
+            {
+                buffer.Append(format.substr(literalStart, i + 1 - literalStart));
+                literalStart = ++i + 1;
+            }
+            else if (c == '{' && hasNext && format[i + 1] == '}')
+            {
+                buffer.Append(format.substr(literalStart, i - literalStart));
+                if (argIndex < argCount)
+                    appendArg(buffer, argIndex++);
+                else
+                    buffer.Append(std::string_view{"{}"});
+                literalStart = ++i + 1;
+            }
+        }
+
+        if (literalStart < format.size())
+            buffer.Append(format.substr(literalStart));
+    }
+
+    // Number of "{}" placeholders in format, or -1 if it has a '{' or '}' that is neither a placeholder nor escaped
+    constexpr int CountLogPlaceholders(std::string_view format)
+    {
+        int count = 0;
+        for (std::size_t i = 0; i < format.size(); ++i)
+        {
+            const char c = format[i];
+            if (c != '{' && c != '}')
+                continue;
+
+            const bool hasNext = i + 1 < format.size();
+            if (hasNext && (format[i + 1] == c || (c == '{' && format[i + 1] == '}')))
+            {
+                count += c == '{' && format[i + 1] == '}';
+                ++i;
+            }
+            else
+                return -1;
+        }
+        return count;
+    }
+
+    namespace detail
+    {
+        // Not constexpr on purpose: reaching one of these while checking a format string is a compile error that
+        // names the problem
+        inline void LogFormatHasUnmatchedBrace() {}
+        inline void LogFormatPlaceholderCountDoesNotMatchArguments() {}
+    }
+
+    // Format string checked at compile time against the arguments it is used with. Also captures the call site,
+    // since a default source_location parameter cannot follow an argument pack.
+    template<typename... Args>
+    class BasicLogFormatString
+    {
+    public:
+        template<typename T> requires std::is_convertible_v<const T &, std::string_view>
+        consteval BasicLogFormatString(const T &format,
+                                       const std::source_location &location = std::source_location::current()) :
+            m_Format(format), m_Location(location)
+        {
+            const int count = CountLogPlaceholders(m_Format);
+            if (count < 0)
+                detail::LogFormatHasUnmatchedBrace();
+            else if (count != static_cast<int>(sizeof...(Args)))
+                detail::LogFormatPlaceholderCountDoesNotMatchArguments();
+        }
+
+        [[nodiscard]] constexpr std::string_view Get() const { return m_Format; }
+        [[nodiscard]] constexpr const std::source_location &GetLocation() const { return m_Location; }
+
+    private:
+        std::string_view m_Format;
+        std::source_location m_Location;
+    };
+
+    // type_identity keeps the arguments from being deduced through the format string
+    template<typename... Args>
+    using LogFormatString = BasicLogFormatString<std::type_identity_t<Args>...>;
+
+    template<typename T>
+    void AppendLogArg(LogFormatBuffer &buffer, const T &value)
+    {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>)
+            buffer.Append(value);
+        else if constexpr (std::is_enum_v<U>)
+            AppendLogArg(buffer, static_cast<std::underlying_type_t<U>>(value));
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+            buffer.Append(static_cast<std::int64_t>(value));
+        else if constexpr (std::is_integral_v<U>)
+            buffer.Append(static_cast<std::uint64_t>(value));
+        else if constexpr (std::is_floating_point_v<U>)
+            buffer.Append(static_cast<double>(value));
+        else if constexpr (std::is_null_pointer_v<U>)
+            buffer.Append(static_cast<const void *>(nullptr));
+        else if constexpr (std::is_convertible_v<const U &, std::string_view>)
+        {
+            if constexpr (std::is_pointer_v<U>)
+            {
+                if (value == nullptr)
+                {
+                    buffer.Append(std::string_view{"(null)"});
+                    return;
+                }
+            }
+            buffer.Append(std::string_view{value});
+        }
+        else if constexpr (std::is_pointer_v<U>)
+            buffer.Append(static_cast<const void *>(value));
+        else
+            static_assert(sizeof(U) == 0, "Unsupported log argument type");
+    }
+}
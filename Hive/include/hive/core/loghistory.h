@@ -0,0 +1,101 @@
+#pragma once
+
+#include <hive/core/log.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace hive
+{
+    struct LogHistoryConfig
+    {
+        std::size_t recordCapacity{16 * 1024}; //Rounded up to a power of two
+        std::size_t textCapacity{1024 * 1024}; //Bytes shared by the messages, rounded up to a power of two
+        LoggerConfig logger{};
+    };
+
+    struct LogHistoryQuery
+    {
+        const LogCategory *category{nullptr}; //This category and its children, every category when null
+        LogSeverity minSeverity{LogSeverity::TRACE};
+        std::uint64_t fromTimestamp{0}; //Clock ticks, see clock.h
+        std::uint64_t toTimestamp{~std::uint64_t{0}};
+        std::uint64_t firstSequence{0}; //To only get what was added since a previous query
+    };
+
+    struct LogHistoryEntry
+    {
+        std::uint64_t sequence;
+        const LogCategory *category;
+        LogSeverity severity;
+        std::uint64_t timestamp;
+        std::string_view message; //Only valid during the callback
+    };
+
+    // Keeps the most recent records for tooling such as an in-game console. Records are fixed-size slots pointing
+    // into a byte ring holding the messages, so logging allocates nothing. Queries never block the loggers: a
+    // record is copied out and discarded if it was overwritten meanwhile (seqlock), so a slow reader can only miss
+    // the oldest records. Records still being written are skipped as well.
+    class LogHistory
+    {
+    public:
+        static constexpr std::size_t MaxMessageLength = LogFormatBuffer::Capacity - 1; //Longer messages are truncated
+
+        explicit LogHistory(LogManager &manager, const LogHistoryConfig &config = {});
+
+        ~LogHistory();
+
+        LogHistory(const LogHistory &other) = delete;
+        LogHistory &operator=(const LogHistory &other) = delete;
+
+        void Log(const LogRecord &record);
+
+        // Calls fn(const LogHistoryEntry &) for each retained record matching the query, oldest first
+        template<typename Fn>
+        void ForEach(const LogHistoryQuery &query, Fn &&fn) const
+        {
+            const std::uint64_t end = m_Head.load(std::memory_order_acquire);
+            const std::uint64_t oldest = end > m_SlotMask + 1 ? end - (m_SlotMask + 1) : 0;
+
+            LogFormatBuffer message;
+            for (std::uint64_t sequence = oldest > query.firstSequence ? oldest : query.firstSequence;
+                 sequence < end; ++sequence)
+            {
+                LogHistoryEntry entry;
+                if (TryRead(sequence, query, entry, message))
+                    fn(static_cast<const LogHistoryEntry &>(entry));
+            }
+        }
+
+        // Sequence the next record will get
+        [[nodiscard]] std::uint64_t GetEndSequence() const { return m_Head.load(std::memory_order_acquire); }
+
+    private:
+        struct Slot
+        {
+            std::atomic<std::uint64_t> version{0}; //Odd while written, 2 * (sequence + 1) once readable
+            const LogCategory *category;
+            std::uint64_t timestamp;
+            std::uint64_t textOffset;
+            std::uint16_t textLength;
+            LogSeverity severity;
+        };
+
+        bool TryRead(std::uint64_t sequence, const LogHistoryQuery &query, LogHistoryEntry &entry,
+                     LogFormatBuffer &message) const;
+
+        LogManager &m_Manager; //the LogManager must have a longer lifetime than this LogHistory
+        const std::size_t m_SlotMask;
+        const std::size_t m_TextMask;
+        std::unique_ptr<Slot[]> m_Slots;
+        std::unique_ptr<char[]> m_Text;
+
+        alignas(64) std::atomic<std::uint64_t> m_Head{0};
+        alignas(64) std::atomic<std::uint64_t> m_TextHead{0};
+
+        LogManager::LoggerId m_LoggerId;
+    };
+}
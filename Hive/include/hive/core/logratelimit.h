@@ -0,0 +1,170 @@
+#pragma once
+
+#include <hive/core/log.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <source_location>
+#include <string_view>
+
+namespace hive
+{
+    // Per call site limit of N messages per interval. The whole state (window start and count) is packed in one
+    // 64-bit atomic, so a check is a clock read and a compare exchange on memory owned by the call site.
+    // Messages over the limit are only counted; the first message after the window closes reports how many were
+    // dropped. A limiter that dropped messages is also listed for ReportSuppressedLogs, so a burst followed by
+    // silence is still reported when the log manager flushes.
+    class LogRateLimiter
+    {
+    public:
+        struct Admission
+        {
+            bool isAllowed;
+            std::uint32_t suppressedCount; //dropped during the previous window, to report before this message
+        };
+
+        constexpr LogRateLimiter(std::uint32_t maxCount, std::chrono::milliseconds interval) : m_MaxCount(maxCount),
+            m_Interval(static_cast<std::uint64_t>(interval.count()))
+        {
+        }
+
+        ~LogRateLimiter();
+
+        LogRateLimiter(const LogRateLimiter &other) = delete;
+        LogRateLimiter &operator=(const LogRateLimiter &other) = delete;
+
+        Admission Admit()
+        {
+            const std::uint64_t now = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count()) & WindowMask;
+
+            std::uint64_t state = m_State.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const std::uint64_t windowStart = state >> CountBits;
+                const auto count = static_cast<std::uint32_t>(state & CountMask);
+
+                std::uint64_t next;
+                Admission admission;
+                if (now >= windowStart + m_Interval)
+                {
+                    next = now << CountBits | 1;
+                    admission = {true, count > m_MaxCount ? count - m_MaxCount : 0};
+                }
+                else
+                {
+                    next = count < CountMask ? state + 1 : state;
+                    admission = {count < m_MaxCount, 0};
+                }
+
+                if (next == state || m_State.compare_exchange_weak(state, next, std::memory_order_relaxed))
+                    return admission;
+            }
+        }
+
+        // Remembers the call site of a dropped message, the first time only
+        void NoteSuppressed(const LogCategory &cat, LogSeverity sev, const std::source_location &location,
+                            std::string_view format)
+        {
+            if (!m_IsListed.load(std::memory_order_relaxed))
+                List(cat, sev, location, format);
+        }
+
+        // Messages dropped in the current window that were not reported yet, which are then considered reported
+        std::uint32_t TakeSuppressedCount()
+        {
+            std::uint64_t state = m_State.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const auto count = static_cast<std::uint32_t>(state & CountMask);
+                if (count <= m_MaxCount)
+                    return 0;
+
+                const std::uint64_t next = (state & ~CountMask) | m_MaxCount;
+                if (m_State.compare_exchange_weak(state, next, std::memory_order_relaxed))
+                    return count - m_MaxCount;
+            }
+        }
+
+    private:
+        friend void ReportSuppressedLogs(LogManager &manager);
+
+        void List(const LogCategory &cat, LogSeverity sev, const std::source_location &location,
+                  std::string_view format);
+
+        static constexpr unsigned int CountBits = 24;
+        static constexpr std::uint64_t CountMask = (std::uint64_t{1} << CountBits) - 1;
+        static constexpr std::uint64_t WindowMask = (std::uint64_t{1} << (64 - CountBits)) - 1;
+
+        const std::uint32_t m_MaxCount;
+        const std::uint64_t m_Interval;
+        std::atomic<std::uint64_t> m_State{0}; //window start in ms << CountBits | messages seen in the window
+
+        //Call site, set once before the limiter is listed
+        std::atomic<bool> m_IsListed{false};
+        const LogCategory *m_Category{nullptr};
+        LogSeverity m_Severity{LogSeverity::INFO};
+        std::source_location m_Location{};
+        std::string_view m_Format{};
+    };
+
+    // Logs the dropped message counts that no later message from the same call site reported yet
+    void ReportSuppressedLogs(LogManager &manager);
+
+    template<typename... Args>
+    void LogRateLimited(LogRateLimiter &limiter, const LogCategory &cat, LogSeverity sev,
+                        LogFormatString<Args...> format, const Args &... args)
+    {
+        if (!cat.IsEnabled(sev))
+            return;
+
+        const LogRateLimiter::Admission admission = limiter.Admit();
+        if (admission.suppressedCount > 0)
+        {
+            LogGeneral(cat, sev, format.GetLocation(), "Suppressed {} repeats of \"{}\"", admission.suppressedCount,
+                       format.Get());
+        }
+
+        if (admission.isAllowed)
+            LogGeneral(cat, sev, format.GetLocation(), format.Get(), args...);
+        else
+            limiter.NoteSuppressed(cat, sev, format.GetLocation(), format.Get());
+    }
+}
+
+// Logs at most maxCount messages per interval (a std::chrono duration) from this call site. Both must be constants.
+#define HIVE_LOG_LIMITED(cat, sev, maxCount, interval, format, ...) \
+    do \
+    { \
+        static constinit ::hive::LogRateLimiter hiveLogRateLimiter{maxCount, interval}; \
+        ::hive::LogRateLimited(hiveLogRateLimiter, cat, sev, format __VA_OPT__(,) __VA_ARGS__); \
+    } while (false)
+
+#if HIVE_LOG_MIN_SEVERITY <= HIVE_LOG_LEVEL_TRACE
+#define HIVE_LOG_TRACE_LIMITED(cat, maxCount, interval, format, ...) \
+    HIVE_LOG_LIMITED(cat, ::hive::LogSeverity::TRACE, maxCount, interval, format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define HIVE_LOG_TRACE_LIMITED(...) HIVE_LOG_STRIPPED()
+#endif
+
+#if HIVE_LOG_MIN_SEVERITY <= HIVE_LOG_LEVEL_INFO
+#define HIVE_LOG_INFO_LIMITED(cat, maxCount, interval, format, ...) \
+    HIVE_LOG_LIMITED(cat, ::hive::LogSeverity::INFO, maxCount, interval, format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define HIVE_LOG_INFO_LIMITED(...) HIVE_LOG_STRIPPED()
+#endif
+
+#if HIVE_LOG_MIN_SEVERITY <= HIVE_LOG_LEVEL_WARN
+#define HIVE_LOG_WARN_LIMITED(cat, maxCount, interval, format, ...) \
+    HIVE_LOG_LIMITED(cat, ::hive::LogSeverity::WARN, maxCount, interval, format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define HIVE_LOG_WARN_LIMITED(...) HIVE_LOG_STRIPPED()
+#endif
+
+#if HIVE_LOG_MIN_SEVERITY <= HIVE_LOG_LEVEL_ERROR
+#define HIVE_LOG_ERROR_LIMITED(cat, maxCount, interval, format, ...) \
+    HIVE_LOG_LIMITED(cat, ::hive::LogSeverity::ERROR, maxCount, interval, format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define HIVE_LOG_ERROR_LIMITED(...) HIVE_LOG_STRIPPED()
+#endif
@@ -1,7 +1,43 @@
 #pragma once
 
+#include <hive/core/logratelimit.h>
+
+#include <chrono>
+#include <cstdint>
+
 namespace hive
 {
+    enum class ModulePhase : std::uint8_t
+    {
+        CONFIGURE, INITIALIZE, SHUTDOWN, COUNT
+    };
+
+    // Last run of a module phase, ticks from clock.h
+    struct ModulePhaseTiming
+    {
+        std::uint64_t startTicks{0};
+        std::uint64_t endTicks{0};
+        std::uint64_t allocationCount{0}; //Made by the running thread, see allocationcounter.h
+        std::uint32_t threadIndex{0}; //Small number per thread, in order of first module run
+        bool hasRun{false};
+    };
+
+    // Run in this order every frame by ModuleRegistry::TickModules
+    enum class TickPhase : std::uint8_t
+    {
+        PRE_UPDATE, UPDATE, POST_UPDATE, RENDER, COUNT
+    };
+
+    struct ModuleTickStats
+    {
+        std::uint64_t tickCount{0};
+        std::uint64_t overrunCount{0}; //Ticks longer than the budget
+        std::uint64_t lastMicroseconds{0};
+        std::uint64_t maxMicroseconds{0};
+        std::uint64_t totalMicroseconds{0};
+        mutable LogRateLimiter overrunLimiter{2, std::chrono::milliseconds{1000}}; //Throttles overrun warnings
+    };
+
     class ModuleContext
     {
     public:
@@ -12,8 +48,28 @@ namespace hive
         }
 
         const std::vector<std::string> &GetDependencies() const { return m_Dependencies; }
+
+        // For modules whose initialization must not leave the main thread, like window system setup
+        void RequireMainThread() { m_IsMainThreadRequired = true; }
+        bool IsMainThreadRequired() const { return m_IsMainThreadRequired; }
+
+        // Opts into DoTick calls during phase. A zero budget uses the default of the registry.
+        void AddTickPhase(TickPhase phase, std::chrono::microseconds budget = {})
+        {
+            m_TickPhases |= 1u << static_cast<unsigned int>(phase);
+            m_TickBudgets[static_cast<std::size_t>(phase)] = budget;
+        }
+
+        bool HasTickPhase(TickPhase phase) const { return (m_TickPhases >> static_cast<unsigned int>(phase)) & 1u; }
+        std::chrono::microseconds GetTickBudget(TickPhase phase) const
+        {
+            return m_TickBudgets[static_cast<std::size_t>(phase)];
+        }
     private:
         std::vector<std::string> m_Dependencies;
+        bool m_IsMainThreadRequired{false};
+        std::uint8_t m_TickPhases{0};
+        std::chrono::microseconds m_TickBudgets[static_cast<std::size_t>(TickPhase::COUNT)]{};
     };
 
     class Module
@@ -29,10 +85,26 @@ namespace hive
 
         void Shutdown();
 
-        bool CanInitialize(const std::unordered_set<std::string> &initModulesNames) const;
+        // Returns whether the tick went over budget
+        bool Tick(TickPhase phase, double deltaSeconds, std::chrono::microseconds budget);
 
         bool IsInitialized() const { return m_IsInitialized; }
 
+        const std::vector<std::string> &GetDependencies() const { return m_Context.GetDependencies(); }
+        bool IsMainThreadRequired() const { return m_Context.IsMainThreadRequired(); }
+
+        const ModulePhaseTiming &GetPhaseTiming(ModulePhase phase) const
+        {
+            return m_PhaseTimings[static_cast<std::size_t>(phase)];
+        }
+
+        bool HasTickPhase(TickPhase phase) const { return m_Context.HasTickPhase(phase); }
+        std::chrono::microseconds GetTickBudget(TickPhase phase) const { return m_Context.GetTickBudget(phase); }
+        const ModuleTickStats &GetTickStats(TickPhase phase) const
+        {
+            return m_TickStats[static_cast<std::size_t>(phase)];
+        }
+
     protected:
         virtual void DoConfigure(ModuleContext &context)
         {
@@ -46,9 +118,15 @@ namespace hive
         {
         }
 
+        virtual void DoTick(TickPhase /*phase*/, double /*deltaSeconds*/)
+        {
+        }
+
     private:
         ModuleContext m_Context;
         bool m_IsInitialized{false};
+        ModulePhaseTiming m_PhaseTimings[static_cast<std::size_t>(ModulePhase::COUNT)];
+        ModuleTickStats m_TickStats[static_cast<std::size_t>(TickPhase::COUNT)];
     };
 
 
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <hive/core/module.h>
+
+#include <cstdint>
+
+namespace hive
+{
+    // Bump when Module or the entry point change in a way libraries built against an older Hive would break
+    constexpr std::uint32_t ModuleLibraryAbiVersion = 1;
+
+    constexpr const char *ModuleLibraryEntrySymbol = "HiveGetModuleLibraryEntry";
+
+    // What a module shared library hands to ModuleRegistry::LoadModuleLibrary. Plain C layout so it can be checked
+    // before anything else of the library is trusted.
+    struct ModuleLibraryEntry
+    {
+        std::uint32_t abiVersion;
+        std::uint32_t moduleSize; //sizeof(Module) the library was built with
+        Module *(*create)();
+    };
+}
+
+#if defined(_WIN32)
+#define HIVE_MODULE_LIBRARY_EXPORT extern "C" __declspec(dllexport)
+#else
+#define HIVE_MODULE_LIBRARY_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+// Entry point of a module built as a shared library, in place of REGISTER_MODULE. The module is deleted through its
+// virtual destructor, so it is freed by the library that allocated it.
+#define HIVE_MODULE_LIBRARY(ModuleClass)                                                            \
+    HIVE_MODULE_LIBRARY_EXPORT const hive::ModuleLibraryEntry *HiveGetModuleLibraryEntry()         \
+    {                                                                                               \
+        static const hive::ModuleLibraryEntry entry{                                                \
+            hive::ModuleLibraryAbiVersion, sizeof(hive::Module),                                    \
+            []() -> hive::Module * { return new ModuleClass(); }                                    \
+        };                                                                                          \
+        return &entry;                                                                              \
+    }
@@ -1,36 +1,145 @@
 #pragma once
+#include <hive/core/log.h>
 #include <hive/core/module.h>
-#include <hive/utils/singleton.h>
+#include <hive/core/threadpool.h>
+#include <hive/platform/sharedlibrary.h>
+#include <hive/utils/event.h>
+#include <hive/utils/serviceregistry.h>
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 namespace hive
 {
+    extern const LogCategory LogHiveModule;
 
-    class ModuleRegistry : public Singleton<ModuleRegistry>
+    struct ModuleTickConfig
+    {
+        std::chrono::microseconds defaultBudget{2000}; //For modules that did not set one with AddTickPhase
+        bool isParallel{true}; //Ticks the modules of a phase on the thread pool where dependencies allow
+        unsigned int workerCount{0}; //0 picks one per hardware thread
+    };
+
+    class ModuleRegistry
     {
     public:
         ModuleRegistry() = default;
-        ~ModuleRegistry() = default;
+        ~ModuleRegistry();
+
+        ModuleRegistry(const ModuleRegistry &other) = delete;
+        ModuleRegistry &operator=(const ModuleRegistry &other) = delete;
 
         using ModuleFactoryFn = std::unique_ptr<Module>(*)();
         void RegisterModule(ModuleFactoryFn fn);
 
+        // Adds the module of a shared library exporting HIVE_MODULE_LIBRARY (see modulelibrary.h). Before
+        // ConfigureModules it is handled like the registered ones, afterwards it is configured, ordered and, when
+        // the modules are running, initialized right away.
+        bool LoadModuleLibrary(const char *path);
+
+        // Shuts the module and everything depending on it down, swaps in the current build of its library and
+        // initializes them again. The old version stays in place when the new one fails to load. Must not be
+        // called while the modules tick, and modules must not keep callbacks into their code past DoShutdown.
+        bool ReloadModule(std::string_view moduleName);
+
         void CreateModules();
-        void ConfigureModules();
+        // Orders the modules after their dependencies. Modules with a missing dependency or in a dependency cycle,
+        // and the modules depending on them, are left out; the reasons are logged and kept in GetConfigureErrors.
+        bool ConfigureModules();
         void InitModules();
+
+        // Initializes each module on a worker thread as soon as all its dependencies are initialized, or on the
+        // calling thread for modules that require the main thread. workerCount 0 picks one per hardware thread.
+        void InitModulesParallel(unsigned int workerCount = 0);
         void ShutdownModules();
 
+        void SetTickConfig(const ModuleTickConfig &config);
+
+        // Runs every tick phase in order. Within a phase a module ticks after the modules it depends on, directly
+        // or through modules not ticking in that phase. Ticks over budget are counted and logged.
+        void TickModules(double deltaSeconds);
+
+        // Logs the average, worst and over budget tick counts of every ticking module
+        void LogTickSummary() const;
+
+        [[nodiscard]] const std::vector<std::string> &GetConfigureErrors() const { return m_ConfigureErrors; }
+
+        // Chrome trace event JSON (chrome://tracing, Perfetto) of the configure, initialize and shutdown runs so far
+        bool WriteTimingTrace(const char *path) const;
+
+        // Logs the slowest modules and the initialization critical path through the dependency graph
+        void LogTimingSummary() const;
+
+        // Broadcast after a module initialized, and right before a module shuts down
+        Event<Module &> &GetModuleInitializedEvent() { return m_ModuleInitialized; }
+        Event<Module &> &GetModuleShutdownEvent() { return m_ModuleShutdown; }
+
     private:
+        struct ModuleLibrary
+        {
+            ~ModuleLibrary();
+
+            std::string path;
+            std::string loadedPath; //Copy of path actually loaded
+            unsigned int generation{0};
+            SharedLibrary library;
+            Module *(*create)(){nullptr};
+        };
+
+        bool OrderModules();
+        std::size_t FindModule(std::string_view name) const; //m_Modules.size() when missing
+        void ShutdownWithDependents(std::size_t index);
+        void FlushLogsBeforeUnload() const;
+        void InitPendingModules();
+        std::unique_ptr<ModuleLibrary> OpenModuleLibrary(const char *path, unsigned int generation);
+
+        void ReportUnorderedModules(const std::vector<std::vector<std::size_t>> &dependencies,
+                                    const std::vector<std::uint32_t> &pendingDependencies);
+
+        // Subset of the modules with the dependencies between them, nodes are indices into modules
+        struct ModuleGraph
+        {
+            std::vector<std::size_t> modules; //Indices into m_Modules, in dependency order
+            std::vector<std::vector<std::size_t>> dependents;
+            std::vector<std::uint32_t> dependencyCounts;
+        };
+
+        void BuildTickGraphs(const std::vector<std::vector<std::size_t>> &dependencies);
+        ThreadPool &GetThreadPool(unsigned int workerCount);
+
+        // Calls run for every module of the graph once its dependencies were run, blocking until all were. Without
+        // a pool everything runs in order on the calling thread.
+        void RunInDependencyOrder(const ModuleGraph &graph, ThreadPool *pool,
+                                  const MoveOnlyFunctor<void(Module &)> &run);
+
         std::vector<ModuleFactoryFn> m_ModuleFactories;
-        std::vector<std::unique_ptr<Module>> m_Modules;
+        std::unordered_map<std::string, std::unique_ptr<ModuleLibrary>> m_ModuleLibraries; //By module name
+        std::vector<std::unique_ptr<Module>> m_Modules; //After m_ModuleLibraries, destroyed before their code unloads
+        bool m_IsConfigured{false};
+        bool m_IsInitialized{false};
+
+        ModuleGraph m_InitGraph;
+        ModuleGraph m_TickGraphs[static_cast<std::size_t>(TickPhase::COUNT)];
+        std::vector<std::string> m_ConfigureErrors;
+
+        ModuleTickConfig m_TickConfig{};
+
+        std::unique_ptr<ThreadPool> m_ThreadPool;
+
+        Event<Module &> m_ModuleInitialized;
+        Event<Module &> m_ModuleShutdown;
     };
 }
 
 #define REGISTER_MODULE(ModuleClass)                                                                \
     void Register##ModuleClass()                                                                    \
     {                                                                                               \
-        hive::ModuleRegistry::GetInstance().RegisterModule([]() -> std::unique_ptr<hive::Module>    \
+        hive::GetService<hive::ModuleRegistry>().RegisterModule([]() -> std::unique_ptr<hive::Module>    \
         {                                                                                           \
             return std::make_unique<ModuleClass>();                                                 \
         });                                                                                         \
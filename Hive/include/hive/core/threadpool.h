@@ -0,0 +1,42 @@
+#pragma once
+
+#include <hive/utils/moveonlyfunctor.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hive
+{
+    // Fixed set of worker threads running submitted tasks in FIFO order
+    class ThreadPool
+    {
+    public:
+        using Task = MoveOnlyFunctor<void()>;
+
+        // 0 uses one thread per hardware thread but the calling one
+        explicit ThreadPool(unsigned int threadCount = 0);
+
+        // Runs the tasks still queued, then joins
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &other) = delete;
+        ThreadPool &operator=(const ThreadPool &other) = delete;
+
+        void Submit(Task task);
+
+        [[nodiscard]] unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_Threads.size()); }
+
+    private:
+        void WorkerMain();
+
+        std::mutex m_Mutex;
+        std::condition_variable m_TaskAvailable;
+        std::deque<Task> m_Tasks;
+        bool m_IsStopping{false};
+
+        std::vector<std::thread> m_Threads;
+    };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+namespace hive
+{
+    // Called from the fatal signal / exception context. Only async-signal-safe work is allowed in there,
+    // which the CrashOutput helpers below are.
+    using CrashCallback = void (*)(int signal);
+
+    // Installs callback for SIGSEGV, SIGABRT, SIGBUS, SIGFPE and SIGILL. After it returns the previous handler
+    // is restored and the signal raised again, so the process still dies the usual way.
+    bool InstallCrashHandler(CrashCallback callback);
+    void RemoveCrashHandler();
+
+    class CrashOutput
+    {
+    public:
+        static constexpr int StandardError = 2;
+
+        static int Open(const char *path);
+        static void Write(int handle, const char *data, std::size_t size);
+        static void Close(int handle);
+    };
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+namespace hive
+{
+    // Read/write shared mapping of a file. Writes land in the page cache, so they survive a crash of the process.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile &other) = delete;
+        MappedFile &operator=(const MappedFile &other) = delete;
+
+        // Creates or truncates path to size bytes and maps it
+        [[nodiscard]] bool Open(const char *path, std::size_t size);
+
+        // Unmaps the file and truncates it to usedSize bytes
+        void Close(std::size_t usedSize);
+        void Close() { Close(m_Size); }
+
+        [[nodiscard]] bool IsOpen() const { return m_Data != nullptr; }
+        [[nodiscard]] std::byte *GetData() const { return m_Data; }
+        [[nodiscard]] std::size_t GetSize() const { return m_Size; }
+
+    private:
+        std::byte *m_Data{nullptr};
+        std::size_t m_Size{0};
+
+#if defined(_WIN32)
+        void *m_FileHandle{nullptr};
+        void *m_MappingHandle{nullptr};
+#else
+        int m_FileDescriptor{-1};
+#endif
+    };
+}
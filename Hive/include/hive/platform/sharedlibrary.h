@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+namespace hive
+{
+    // Shared library (.so, .dll) loaded at runtime
+    class SharedLibrary
+    {
+    public:
+        SharedLibrary() = default;
+        ~SharedLibrary();
+
+        SharedLibrary(const SharedLibrary &other) = delete;
+        SharedLibrary &operator=(const SharedLibrary &other) = delete;
+
+        [[nodiscard]] bool Open(const char *path);
+
+        // Everything the library defined, code included, is gone afterwards
+        void Close();
+
+        [[nodiscard]] void *FindSymbol(const char *name) const;
+
+        [[nodiscard]] bool IsOpen() const { return m_Handle != nullptr; }
+
+        // Reason of the last failed Open or FindSymbol
+        [[nodiscard]] const std::string &GetError() const { return m_Error; }
+
+    private:
+        void *m_Handle{nullptr};
+        mutable std::string m_Error;
+    };
+}
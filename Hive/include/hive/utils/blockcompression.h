@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+namespace hive
+{
+    // LZ4 block format: greedy matching with a single-entry hash table, byte-aligned tokens and no entropy coding,
+    // so both directions run at memory speed. Blocks are independent, a block never references another one.
+
+    // Worst-case compressed size of size bytes, for sizing the output buffer
+    [[nodiscard]] constexpr std::size_t GetCompressBound(std::size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    // Returns the compressed size, or 0 if capacity is below GetCompressBound(size)
+    std::size_t CompressBlock(const std::byte *source, std::size_t size, std::byte *destination,
+                              std::size_t capacity);
+
+    // Returns the decompressed size, or 0 if the block is malformed or does not fit in capacity
+    std::size_t DecompressBlock(const std::byte *source, std::size_t size, std::byte *destination,
+                                std::size_t capacity);
+}
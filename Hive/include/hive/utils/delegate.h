@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace hive
+{
+    template<typename Signature>
+    class Delegate;
+
+    // Non-owning callback whose target is fixed at compile time: Delegate<void(int)>::Bind<&Foo::Bar>(&foo).
+    // It is only an object pointer and a thunk pointer, trivially copyable, and the thunk calls the target directly so
+    // the compiler can inline it. The bound object must outlive the delegate.
+    template<typename R, typename... Args>
+    class Delegate<R(Args...)>
+    {
+    public:
+        Delegate() = default;
+
+        // Free or static function
+        template<auto Function> requires std::is_invocable_r_v<R, decltype(Function), Args...>
+        [[nodiscard]] static constexpr Delegate Bind()
+        {
+            return Delegate{
+                nullptr, [](void *, Args &&... args) -> R
+                {
+                    return std::invoke(Function, std::forward<Args>(args)...);
+                }
+            };
+        }
+
+        // Member function of obj, or a free function taking obj as its first parameter
+        template<auto Method, typename T> requires std::is_invocable_r_v<R, decltype(Method), T *, Args...>
+        [[nodiscard]] static constexpr Delegate Bind(T *obj)
+        {
+            return Delegate{
+                const_cast<std::remove_const_t<T> *>(obj), [](void *object, Args &&... args) -> R
+                {
+                    return std::invoke(Method, static_cast<T *>(object), std::forward<Args>(args)...);
+                }
+            };
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return m_Thunk == nullptr; }
+        explicit operator bool() const noexcept { return m_Thunk != nullptr; }
+
+        // The same target bound to the same object, used to find a delegate again when unregistering
+        bool operator==(const Delegate &other) const noexcept = default;
+
+        R operator()(Args... args) const
+        {
+            return m_Thunk(m_Object, std::forward<Args>(args)...);
+        }
+
+    private:
+        using Thunk = R (*)(void *object, Args &&... args);
+
+        constexpr Delegate(void *object, Thunk thunk) : m_Object(object), m_Thunk(thunk) {}
+
+        void *m_Object{nullptr};
+        Thunk m_Thunk{nullptr};
+    };
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <hive/utils/delegate.h>
+#include <hive/utils/rcuvalue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace hive
+{
+    namespace detail
+    {
+        // Broadcasts running on the calling thread, linked through the stack, innermost first
+        struct EventBroadcastScope
+        {
+            explicit EventBroadcastScope(const void *event) : event(event), outer(innermost)
+            {
+                innermost = this;
+            }
+
+            ~EventBroadcastScope()
+            {
+                innermost = outer;
+            }
+
+            EventBroadcastScope(const EventBroadcastScope &other) = delete;
+            EventBroadcastScope &operator=(const EventBroadcastScope &other) = delete;
+
+            static bool IsActive(const void *event)
+            {
+                for (const EventBroadcastScope *scope = innermost; scope != nullptr; scope = scope->outer)
+                {
+                    if (scope->event == event)
+                        return true;
+                }
+                return false;
+            }
+
+            const void *event;
+            EventBroadcastScope *outer;
+
+            static inline thread_local EventBroadcastScope *innermost{nullptr};
+        };
+    }
+
+    // Unsubscribes from its event when destroyed. The event must outlive it, unless Release was called.
+    class EventSubscription
+    {
+    public:
+        EventSubscription() = default;
+
+        EventSubscription(EventSubscription &&other) noexcept : m_Event(std::exchange(other.m_Event, nullptr)),
+            m_Unsubscribe(other.m_Unsubscribe),
+            m_Id(other.m_Id)
+        {
+        }
+
+        EventSubscription &operator=(EventSubscription &&other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_Event = std::exchange(other.m_Event, nullptr);
+                m_Unsubscribe = other.m_Unsubscribe;
+                m_Id = other.m_Id;
+            }
+            return *this;
+        }
+
+        EventSubscription(const EventSubscription &other) = delete;
+        EventSubscription &operator=(const EventSubscription &other) = delete;
+
+        ~EventSubscription()
+        {
+            Reset();
+        }
+
+        void Reset()
+        {
+            if (m_Event)
+                m_Unsubscribe(std::exchange(m_Event, nullptr), m_Id);
+        }
+
+        // Keeps the callback subscribed for the rest of the event lifetime
+        void Release() { m_Event = nullptr; }
+
+        [[nodiscard]] bool IsActive() const { return m_Event != nullptr; }
+
+    private:
+        template<typename... Args>
+        friend class Event;
+
+        using UnsubscribeFn = void (*)(void *event, std::uint64_t id);
+
+        EventSubscription(void *event, UnsubscribeFn unsubscribe, std::uint64_t id) : m_Event(event),
+            m_Unsubscribe(unsubscribe),
+            m_Id(id)
+        {
+        }
+
+        void *m_Event{nullptr};
+        UnsubscribeFn m_Unsubscribe{nullptr};
+        std::uint64_t m_Id{0};
+    };
+
+    // Multicast callback list. Subscribers are stored contiguously and published read-copy-update, so Broadcast
+    // takes no lock and subscriptions can come and go from any thread while other threads broadcast. Subscribing
+    // and unsubscribing wait for in-flight broadcasts, except from inside a callback of the same event: there the
+    // change is deferred until the outermost broadcast on that thread returns, and a callback unsubscribed that
+    // way is already skipped by the rest of that broadcast and by broadcasts started after it. Subscribers are
+    // called in subscription order.
+    template<typename... Args>
+    class Event
+    {
+    public:
+        using Callback = Delegate<void(Args...)>;
+
+        Event() = default;
+
+        Event(const Event &other) = delete;
+        Event &operator=(const Event &other) = delete;
+
+        // Usage: auto subscription = event.Subscribe<&Listener::OnEvent>(this)
+        template<auto Method, typename T>
+        [[nodiscard]] EventSubscription Subscribe(T *obj)
+        {
+            return Subscribe(Callback::template Bind<Method>(obj));
+        }
+
+        template<auto Function>
+        [[nodiscard]] EventSubscription Subscribe()
+        {
+            return Subscribe(Callback::template Bind<Function>());
+        }
+
+        [[nodiscard]] EventSubscription Subscribe(Callback callback)
+        {
+            const std::uint64_t id = ++m_IdCount;
+            if (detail::EventBroadcastScope::IsActive(this))
+            {
+                Defer({id, callback});
+            }
+            else
+            {
+                m_Subscribers.Update([&](std::vector<Subscriber> &subscribers)
+                {
+                    subscribers.push_back({id, callback});
+                });
+            }
+            return EventSubscription{this, &Event::Unsubscribe, id};
+        }
+
+        void Broadcast(Args... args)
+        {
+            {
+                const detail::EventBroadcastScope scope{this};
+                const auto subscribers = m_Subscribers.Read();
+                for (const Subscriber &subscriber : *subscribers)
+                {
+                    if (m_HasPending.load(std::memory_order_acquire) && IsPendingRemoval(subscriber.id))
+                        continue;
+
+                    subscriber.callback(args...);
+                }
+            }
+
+            if (m_HasPending.load(std::memory_order_acquire) && !detail::EventBroadcastScope::IsActive(this))
+                ApplyPending();
+        }
+
+        [[nodiscard]] std::size_t GetSubscriberCount() const { return m_Subscribers.Read()->size(); }
+
+    private:
+        // Also used for changes deferred by callbacks, where an empty callback is a removal
+        struct Subscriber
+        {
+            std::uint64_t id;
+            Callback callback;
+        };
+
+        static void Unsubscribe(void *event, std::uint64_t id)
+        {
+            auto &self = *static_cast<Event *>(event);
+            if (detail::EventBroadcastScope::IsActive(&self))
+            {
+                self.Defer({id, {}});
+                return;
+            }
+
+            self.m_Subscribers.Update([&self, id](std::vector<Subscriber> &subscribers)
+            {
+                //Subscribed from a callback that has not returned yet. Dropped inside the update, which ApplyPending
+                //is serialized with, so the addition cannot be published after the erase below.
+                if (self.m_HasPending.load(std::memory_order_acquire))
+                {
+                    std::lock_guard lock(self.m_PendingMutex);
+                    std::erase_if(self.m_Pending, [id](const Subscriber &change) { return change.id == id; });
+                    self.m_HasPending.store(!self.m_Pending.empty(), std::memory_order_release);
+                }
+
+                std::erase_if(subscribers, [id](const Subscriber &subscriber) { return subscriber.id == id; });
+            });
+        }
+
+        void Defer(const Subscriber &change)
+        {
+            std::lock_guard lock(m_PendingMutex);
+            m_Pending.push_back(change);
+            m_HasPending.store(true, std::memory_order_release);
+        }
+
+        bool IsPendingRemoval(std::uint64_t id)
+        {
+            std::lock_guard lock(m_PendingMutex);
+            return std::any_of(m_Pending.begin(), m_Pending.end(),
+                               [id](const Subscriber &change) { return change.id == id && !change.callback; });
+        }
+
+        void ApplyPending()
+        {
+            //Changes are applied by id, so two threads applying the same ones concurrently is harmless
+            std::vector<Subscriber> changes;
+            m_Subscribers.Update([this, &changes](std::vector<Subscriber> &subscribers)
+            {
+                {
+                    std::lock_guard lock(m_PendingMutex);
+                    changes = m_Pending;
+                }
+
+                for (const Subscriber &change : changes)
+                {
+                    const auto it = std::find_if(subscribers.begin(), subscribers.end(),
+                                                 [&change](const Subscriber &subscriber)
+                                                 {
+                                                     return subscriber.id == change.id;
+                                                 });
+                    if (!change.callback && it != subscribers.end())
+                        subscribers.erase(it);
+                    else if (change.callback && it == subscribers.end())
+                        subscribers.push_back(change);
+                }
+            });
+
+            //Only dropped once published, until then other broadcasts keep skipping the removed callbacks
+            std::lock_guard lock(m_PendingMutex);
+            std::erase_if(m_Pending, [&changes](const Subscriber &pending)
+            {
+                return std::any_of(changes.begin(), changes.end(), [&pending](const Subscriber &change)
+                {
+                    return change.id == pending.id && change.callback.empty() == pending.callback.empty();
+                });
+            });
+            m_HasPending.store(!m_Pending.empty(), std::memory_order_release);
+        }
+
+        RcuValue<std::vector<Subscriber>> m_Subscribers;
+        std::atomic<std::uint64_t> m_IdCount{0};
+
+        std::mutex m_PendingMutex;
+        std::vector<Subscriber> m_Pending;
+        std::atomic<bool> m_HasPending{false};
+    };
+}
@@ -144,7 +144,7 @@ namespace hive
          if (ptr) ptr->~invoquable();
       }
 
-      R operator()(Args... args)
+      R operator()(Args... args) const
       {
          return ptr->invoquer(std::forward<Args>(args)...);
       }
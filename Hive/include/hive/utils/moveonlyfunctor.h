@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace hive
+{
+    template<typename Signature, std::size_t InlineSize = 3 * sizeof(void *)>
+    class MoveOnlyFunctor;
+
+    // Sibling of Functor for arbitrary callables, capturing lambdas included. Callables that fit in InlineSize bytes
+    // and are nothrow movable live in the inline buffer, larger ones on the heap. Calls go through a static table of
+    // function pointers per stored type instead of a virtual interface, and the stored callable only needs to be
+    // movable, so it can own a unique_ptr.
+    template<typename R, typename... Args, std::size_t InlineSize>
+    class MoveOnlyFunctor<R(Args...), InlineSize>
+    {
+    public:
+        MoveOnlyFunctor() = default;
+        MoveOnlyFunctor(std::nullptr_t) {}
+
+        template<typename F> requires (!std::is_same_v<std::remove_cvref_t<F>, MoveOnlyFunctor> &&
+                                       std::is_invocable_r_v<R, std::decay_t<F> &, Args...>)
+        MoveOnlyFunctor(F &&callable)
+        {
+            using Stored = std::decay_t<F>;
+
+            if constexpr (std::is_pointer_v<Stored> || std::is_member_pointer_v<Stored>)
+            {
+                if (callable == nullptr)
+                    return;
+            }
+
+            if constexpr (IsStoredInline<Stored>)
+            {
+                ::new(static_cast<void *>(m_Storage)) Stored(std::forward<F>(callable));
+                m_VTable = &InlineVTable<Stored>;
+            }
+            else
+            {
+                ::new(static_cast<void *>(m_Storage)) Stored *(new Stored(std::forward<F>(callable)));
+                m_VTable = &HeapVTable<Stored>;
+            }
+        }
+
+        // Same binding as Functor
+        template<typename T>
+        MoveOnlyFunctor(T *obj, R (T::*method)(Args...)) : MoveOnlyFunctor(MethodCall<T, R (T::*)(Args...)>{obj, method})
+        {
+        }
+
+        template<typename T>
+        MoveOnlyFunctor(T *obj, R (T::*method)(Args...) const) :
+            MoveOnlyFunctor(MethodCall<T, R (T::*)(Args...) const>{obj, method})
+        {
+        }
+
+        MoveOnlyFunctor(MoveOnlyFunctor &&other) noexcept
+        {
+            MoveFrom(other);
+        }
+
+        MoveOnlyFunctor &operator=(MoveOnlyFunctor &&other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        MoveOnlyFunctor &operator=(std::nullptr_t) noexcept
+        {
+            Reset();
+            return *this;
+        }
+
+        MoveOnlyFunctor(const MoveOnlyFunctor &other) = delete;
+        MoveOnlyFunctor &operator=(const MoveOnlyFunctor &other) = delete;
+
+        ~MoveOnlyFunctor()
+        {
+            Reset();
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return m_VTable == nullptr; }
+        explicit operator bool() const noexcept { return m_VTable != nullptr; }
+
+        R operator()(Args... args) const
+        {
+            return m_VTable->invoke(m_Storage, std::forward<Args>(args)...);
+        }
+
+    private:
+        struct VTable
+        {
+            R (*invoke)(void *storage, Args &&... args);
+            void (*move)(void *destination, void *source) noexcept; //Also destroys the source, null when a copy of the bytes does
+            void (*destroy)(void *storage) noexcept;
+        };
+
+        template<typename T, typename Method>
+        struct MethodCall
+        {
+            R operator()(Args... args) const
+            {
+                return (obj->*method)(std::forward<Args>(args)...);
+            }
+
+            T *obj;
+            Method method;
+        };
+
+        static constexpr std::size_t StorageAlignment = alignof(std::max_align_t);
+
+        template<typename F>
+        static constexpr bool IsStoredInline = sizeof(F) <= InlineSize && alignof(F) <= StorageAlignment &&
+                                               std::is_nothrow_move_constructible_v<F>;
+
+        template<typename F>
+        static constexpr VTable InlineVTable{
+            [](void *storage, Args &&... args) -> R
+            {
+                return std::invoke(*static_cast<F *>(storage), std::forward<Args>(args)...);
+            },
+            std::is_trivially_copyable_v<F>
+                ? nullptr
+                : +[](void *destination, void *source) noexcept
+                {
+                    F *callable = static_cast<F *>(source);
+                    ::new(destination) F(std::move(*callable));
+                    callable->~F();
+                },
+            [](void *storage) noexcept
+            {
+                static_cast<F *>(storage)->~F();
+            }
+        };
+
+        template<typename F>
+        static constexpr VTable HeapVTable{
+            [](void *storage, Args &&... args) -> R
+            {
+                return std::invoke(**static_cast<F **>(storage), std::forward<Args>(args)...);
+            },
+            nullptr,
+            [](void *storage) noexcept
+            {
+                delete *static_cast<F **>(storage);
+            }
+        };
+
+        void MoveFrom(MoveOnlyFunctor &other) noexcept
+        {
+            if (other.m_VTable == nullptr)
+                return;
+
+            if (other.m_VTable->move)
+                other.m_VTable->move(m_Storage, other.m_Storage);
+            else
+                std::memcpy(m_Storage, other.m_Storage, StorageSize);
+            m_VTable = std::exchange(other.m_VTable, nullptr);
+        }
+
+        void Reset() noexcept
+        {
+            if (m_VTable)
+                std::exchange(m_VTable, nullptr)->destroy(m_Storage);
+        }
+
+        static constexpr std::size_t StorageSize = InlineSize < sizeof(void *) ? sizeof(void *) : InlineSize;
+
+        alignas(StorageAlignment) mutable std::byte m_Storage[StorageSize];
+        const VTable *m_VTable{nullptr};
+    };
+}
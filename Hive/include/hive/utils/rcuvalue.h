@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace hive
+{
+    // Read-mostly value published through an atomic pointer (read-copy-update).
+    // Readers are wait-free: they pin the current version with one counter increment and never retry.
+    // Writers are serialized, publish a modified copy and wait until no reader can still hold the previous
+    // version before deleting it, so Update must never be called while holding a ReadGuard on the same value.
+    template<typename T>
+    class RcuValue
+    {
+    public:
+        class ReadGuard
+        {
+        public:
+            ReadGuard(const ReadGuard &other) = delete;
+            ReadGuard &operator=(const ReadGuard &other) = delete;
+
+            ~ReadGuard()
+            {
+                m_Counter.fetch_sub(1, std::memory_order_release);
+            }
+
+            const T &operator*() const { return *m_Value; }
+            const T *operator->() const { return m_Value; }
+
+        private:
+            friend class RcuValue;
+
+            ReadGuard(std::atomic<std::uint64_t> &counter, const T *value) : m_Counter(counter), m_Value(value)
+            {
+            }
+
+            std::atomic<std::uint64_t> &m_Counter;
+            const T *m_Value;
+        };
+
+        RcuValue() : m_Current(new T{})
+        {
+        }
+
+        ~RcuValue()
+        {
+            delete m_Current.load(std::memory_order_acquire);
+        }
+
+        RcuValue(const RcuValue &other) = delete;
+        RcuValue &operator=(const RcuValue &other) = delete;
+
+        [[nodiscard]] ReadGuard Read() const
+        {
+            std::atomic<std::uint64_t> &counter = m_Readers[m_Epoch.load(std::memory_order_acquire) & 1];
+            counter.fetch_add(1, std::memory_order_seq_cst);
+            return ReadGuard{counter, m_Current.load(std::memory_order_seq_cst)};
+        }
+
+        // Applies mutator to a copy of the current value and publishes it
+        template<typename Fn>
+        void Update(Fn &&mutator)
+        {
+            std::lock_guard lock(m_WriteMutex);
+
+            auto next = std::make_unique<T>(*m_Current.load(std::memory_order_relaxed));
+            mutator(*next);
+
+            std::unique_ptr<T> previous{m_Current.exchange(next.release(), std::memory_order_seq_cst)};
+            Synchronize();
+        }
+
+    private:
+        // Two epoch flips: a reader that sampled the epoch before the exchange but incremented its counter after
+        // the first wait still loads the new pointer, and is covered by the second wait of the next update.
+        void Synchronize()
+        {
+            for (int phase = 0; phase < 2; ++phase)
+            {
+                const std::uint64_t previousEpoch = m_Epoch.fetch_add(1, std::memory_order_seq_cst);
+                while (m_Readers[previousEpoch & 1].load(std::memory_order_seq_cst) != 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        std::atomic<T *> m_Current;
+        std::atomic<std::uint64_t> m_Epoch{0};
+        mutable std::atomic<std::uint64_t> m_Readers[2]{};
+        std::mutex m_WriteMutex;
+    };
+}
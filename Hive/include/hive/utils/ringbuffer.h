@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace hive
+{
+    // Bounded lock-free ring buffer (Vyukov). Any thread may push, and popping is CAS based so producers
+    // can also discard the oldest entry when implementing an overwrite policy.
+    // Capacity is rounded up to a power of two.
+    template<typename T>
+    class MpscRingBuffer
+    {
+    public:
+        explicit MpscRingBuffer(std::size_t capacity) : m_Mask(RoundUpPow2(capacity) - 1),
+                                                        m_Cells(std::make_unique<Cell[]>(m_Mask + 1))
+        {
+            for (std::size_t i = 0; i <= m_Mask; ++i)
+            {
+                m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscRingBuffer(const MpscRingBuffer &other) = delete;
+        MpscRingBuffer &operator=(const MpscRingBuffer &other) = delete;
+
+        // Claims a slot and lets writer fill it in place. Returns false when the buffer is full.
+        template<typename Fn>
+        bool TryEmplace(Fn &&writer)
+        {
+            std::size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = m_Cells[pos & m_Mask];
+                const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        writer(cell.value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_EnqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Hands the oldest entry to reader. Returns false when the buffer is empty.
+        template<typename Fn>
+        bool TryConsume(Fn &&reader)
+        {
+            std::size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = m_Cells[pos & m_Mask];
+                const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (m_DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        reader(cell.value);
+                        cell.sequence.store(pos + m_Mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_DequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Drops the oldest entry, used by producers to make room.
+        bool TryDiscard()
+        {
+            return TryConsume([](T &) {});
+        }
+
+        [[nodiscard]] std::size_t GetCapacity() const { return m_Mask + 1; }
+        [[nodiscard]] std::size_t GetEnqueuePosition() const { return m_EnqueuePos.load(std::memory_order_acquire); }
+        [[nodiscard]] std::size_t GetDequeuePosition() const { return m_DequeuePos.load(std::memory_order_acquire); }
+
+    private:
+        static constexpr std::size_t CacheLineSize = 64;
+
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        static std::size_t RoundUpPow2(std::size_t value)
+        {
+            std::size_t result = 2;
+            while (result < value)
+                result <<= 1;
+            return result;
+        }
+
+        const std::size_t m_Mask;
+        std::unique_ptr<Cell[]> m_Cells;
+
+        alignas(CacheLineSize) std::atomic<std::size_t> m_EnqueuePos{0};
+        alignas(CacheLineSize) std::atomic<std::size_t> m_DequeuePos{0};
+    };
+}
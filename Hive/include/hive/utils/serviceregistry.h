@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <source_location>
+#include <utility>
+#include <vector>
+
+namespace hive
+{
+    namespace detail
+    {
+        // One slot per service type, so a lookup is a single load from an address known at link time
+        template<typename T>
+        struct ServiceSlot
+        {
+            static inline std::atomic<T *> instance{nullptr};
+        };
+
+        [[noreturn]] void ReportMissingService(const char *function);
+        [[noreturn]] void ReportDuplicateService(const char *function);
+    }
+
+    // Published service of type T, null when none is
+    template<typename T>
+    [[nodiscard]] T *TryGetService()
+    {
+        return detail::ServiceSlot<T>::instance.load(std::memory_order_acquire);
+    }
+
+    // Published service of type T. Debug builds abort with the type name when there is none.
+    template<typename T>
+    [[nodiscard]] T &GetService()
+    {
+        T *service = TryGetService<T>();
+#ifndef NDEBUG
+        if (service == nullptr)
+            detail::ReportMissingService(std::source_location::current().function_name());
+#endif
+        return *service;
+    }
+
+    template<typename T>
+    [[nodiscard]] bool HasService()
+    {
+        return TryGetService<T>() != nullptr;
+    }
+
+    // Publishes services for as long as the scope lives, and withdraws them in reverse order when it is destroyed.
+    // Lookups from other threads see a service fully constructed, but stopping them from using a service past the
+    // end of its scope is up to the owner of the scope, as for any other object lifetime.
+    class ServiceScope
+    {
+    public:
+        ServiceScope() = default;
+
+        ~ServiceScope()
+        {
+            Clear();
+        }
+
+        ServiceScope(const ServiceScope &other) = delete;
+        ServiceScope &operator=(const ServiceScope &other) = delete;
+
+        // Publishes a service owned elsewhere. A type has at most one service: debug builds abort on a second
+        // one, release builds keep the first and return false.
+        template<typename T>
+        bool Provide(T &service)
+        {
+            m_Entries.push_back({&service, &Withdraw<T>, nullptr});
+
+            T *expected = nullptr;
+            if (!detail::ServiceSlot<T>::instance.compare_exchange_strong(expected, &service,
+                                                                           std::memory_order_acq_rel))
+            {
+                m_Entries.pop_back();
+#ifndef NDEBUG
+                detail::ReportDuplicateService(std::source_location::current().function_name());
+#endif
+                return false;
+            }
+            return true;
+        }
+
+        // Constructs a service owned by the scope, destroyed after it was withdrawn. Fails like Provide when the
+        // type already has a service, returning that one.
+        template<typename T, typename... Args>
+        T &Emplace(Args &&... args)
+        {
+            auto service = std::make_unique<T>(std::forward<Args>(args)...);
+            if (!Provide(*service))
+                return GetService<T>();
+
+            m_Entries.back().destroy = &Destroy<T>;
+            return *service.release();
+        }
+
+        // Withdraws and destroys everything in reverse order
+        void Clear()
+        {
+            while (!m_Entries.empty())
+            {
+                const Entry entry = m_Entries.back();
+                m_Entries.pop_back();
+
+                entry.withdraw(entry.service);
+                if (entry.destroy)
+                    entry.destroy(entry.service);
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            void *service;
+            void (*withdraw)(void *service);
+            void (*destroy)(void *service); //Null when not owned by the scope
+        };
+
+        template<typename T>
+        static void Withdraw(void *service)
+        {
+            T *expected = static_cast<T *>(service);
+            detail::ServiceSlot<T>::instance.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+        }
+
+        template<typename T>
+        static void Destroy(void *service)
+        {
+            delete static_cast<T *>(service);
+        }
+
+        std::vector<Entry> m_Entries;
+    };
+}
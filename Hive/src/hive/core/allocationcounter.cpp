@@ -0,0 +1,44 @@
+#include <hive/precomp.h>
+#include <hive/core/allocationcounter.h>
+
+#include <cstdlib>
+#include <new>
+
+namespace hive
+{
+    namespace
+    {
+        thread_local std::uint64_t t_AllocationCount{0};
+    }
+
+    std::uint64_t GetThreadAllocationCount()
+    {
+        return t_AllocationCount;
+    }
+
+    bool IsAllocationTrackingEnabled()
+    {
+#ifdef HIVE_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+#ifdef HIVE_TRACK_ALLOCATIONS
+//The array, nothrow and sized forms all end up in these two
+void *operator new(std::size_t size)
+{
+    hive::t_AllocationCount++;
+    if (void *memory = std::malloc(size != 0 ? size : 1))
+        return memory;
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+#endif
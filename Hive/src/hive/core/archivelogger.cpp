@@ -0,0 +1,212 @@
+#include <hive/precomp.h>
+#include <hive/core/archivelogger.h>
+#include <hive/core/logformat.h>
+#include <hive/utils/blockcompression.h>
+
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace hive
+{
+    namespace
+    {
+        // Index of a segment file named <prefix><n>.hla
+        std::optional<unsigned int> ParseSegmentIndex(std::string_view fileName, std::string_view prefix)
+        {
+            constexpr std::string_view extension = ".hla";
+            if (fileName.size() <= prefix.size() + extension.size() || !fileName.starts_with(prefix) ||
+                !fileName.ends_with(extension))
+                return std::nullopt;
+
+            const std::string_view digits = fileName.substr(prefix.size(),
+                                                            fileName.size() - prefix.size() - extension.size());
+            unsigned int index = 0;
+            const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+            if (error != std::errc{} || end != digits.data() + digits.size())
+                return std::nullopt;
+            return index;
+        }
+    }
+
+    ArchiveLogger::ArchiveLogger(LogManager &manager, const ArchiveLoggerConfig &config) : m_Manager(manager),
+        m_BasePath(config.basePath),
+        m_BlockSize(config.blockSize),
+        m_SegmentSize(config.segmentSize),
+        m_MaxSegments(config.maxSegments),
+        m_MaxBlockAge(static_cast<std::uint64_t>(std::chrono::nanoseconds{config.maxBlockAge}.count()))
+    {
+        m_Block.reserve(m_BlockSize + LogFormatBuffer::Capacity);
+        m_Compressed.resize(GetCompressBound(m_BlockSize + LogFormatBuffer::Capacity));
+
+        //Continue after the segments of previous runs instead of overwriting them, and prune from their oldest
+        const std::filesystem::path basePath{m_BasePath};
+        const std::string prefix = basePath.filename().string() + ".";
+        const std::filesystem::path directory = basePath.has_parent_path() ? basePath.parent_path() : ".";
+
+        std::error_code error;
+        bool hasSegments = false;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+        {
+            const std::optional<unsigned int> index = ParseSegmentIndex(entry.path().filename().string(), prefix);
+            if (!index)
+                continue;
+
+            m_OldestSegmentIndex = hasSegments && m_OldestSegmentIndex < *index ? m_OldestSegmentIndex : *index;
+            m_SegmentIndex = hasSegments && m_SegmentIndex > *index + 1 ? m_SegmentIndex : *index + 1;
+            hasSegments = true;
+        }
+
+        m_LoggerId = m_Manager.RegisterLogger<&ArchiveLogger::Log, &ArchiveLogger::OnBatchWritten>(this, config.logger);
+        m_FlushSubscription = m_Manager.GetFlushEvent().Subscribe<&ArchiveLogger::Flush>(this);
+    }
+
+    ArchiveLogger::~ArchiveLogger()
+    {
+        m_FlushSubscription.Reset();
+        m_Manager.UnregisterLogger(m_LoggerId);
+
+        std::lock_guard lock(m_Mutex);
+        WriteBlock();
+        CloseSegment();
+    }
+
+    void ArchiveLogger::Log(const LogRecord &record)
+    {
+        const std::uint64_t timestamp = ClockTicksToWallNanoseconds(record.timestamp);
+
+        LogFormatBuffer line;
+        line.Append('[');
+        line.Append(timestamp / 1000000000);
+        line.Append('.');
+        const std::uint64_t nanoseconds = timestamp % 1000000000;
+        for (std::uint64_t divisor = 100000000; divisor > 0; divisor /= 10)
+        {
+            line.Append(static_cast<char>('0' + nanoseconds / divisor % 10));
+        }
+        line.Append(std::string_view{"] ["});
+        line.Append(std::string_view{GetSeverityName(record.severity)});
+        line.Append(std::string_view{"] "});
+        line.Append(record.category.GetFullPath());
+        line.Append(std::string_view{" - "});
+        line.Append(std::string_view{record.message});
+
+        if (record.location.line() != 0)
+        {
+            const std::string_view file = record.location.file_name();
+            line.Append(std::string_view{" ("});
+            line.Append(file.substr(file.find_last_of("/\\") + 1));
+            line.Append(':');
+            line.Append(static_cast<std::uint64_t>(record.location.line()));
+            line.Append(')');
+        }
+        line.Append('\n');
+
+        std::lock_guard lock(m_Mutex);
+        if (m_Block.size() + line.Size() > m_BlockSize)
+            WriteBlock();
+
+        if (m_LineCount == 0)
+            m_FirstTimestamp = timestamp;
+        m_LastTimestamp = timestamp;
+        m_LineCount++;
+
+        const auto *bytes = reinterpret_cast<const std::byte *>(line.CStr());
+        m_Block.insert(m_Block.end(), bytes, bytes + line.Size());
+    }
+
+    void ArchiveLogger::Flush()
+    {
+        std::lock_guard lock(m_Mutex);
+        WriteBlock();
+    }
+
+    void ArchiveLogger::OnBatchWritten()
+    {
+        if (m_MaxBlockAge == 0)
+            return;
+
+        std::lock_guard lock(m_Mutex);
+        if (m_LineCount != 0 && ClockTicksToWallNanoseconds(ReadClockTicks()) - m_FirstTimestamp >= m_MaxBlockAge)
+            WriteBlock();
+    }
+
+    void ArchiveLogger::WriteBlock()
+    {
+        if (m_Block.empty())
+            return;
+
+        if ((m_Segment == nullptr || m_SegmentOffset >= m_SegmentSize) && !OpenSegment())
+        {
+            m_Block.clear();
+            m_LineCount = 0;
+            return;
+        }
+
+        const std::size_t compressedSize = CompressBlock(m_Block.data(), m_Block.size(), m_Compressed.data(),
+                                                         m_Compressed.size());
+
+        const BlockHeader header{
+            BlockMagic, static_cast<std::uint32_t>(m_Block.size()), static_cast<std::uint32_t>(compressedSize),
+            m_LineCount, m_FirstTimestamp, m_LastTimestamp
+        };
+        const IndexEntry entry{m_FirstTimestamp, m_LastTimestamp, m_SegmentOffset};
+
+        std::fwrite(&header, sizeof(header), 1, m_Segment);
+        std::fwrite(m_Compressed.data(), compressedSize, 1, m_Segment);
+        std::fwrite(&entry, sizeof(entry), 1, m_Index);
+        std::fflush(m_Segment);
+        std::fflush(m_Index);
+
+        m_SegmentOffset += sizeof(header) + compressedSize;
+        m_Block.clear();
+        m_LineCount = 0;
+    }
+
+    bool ArchiveLogger::OpenSegment()
+    {
+        if (m_Segment)
+        {
+            CloseSegment();
+            m_SegmentIndex++;
+        }
+
+        m_Segment = std::fopen(GetSegmentPath(m_SegmentIndex, "hla").c_str(), "wb");
+        m_Index = std::fopen(GetSegmentPath(m_SegmentIndex, "hli").c_str(), "wb");
+        m_SegmentOffset = 0;
+
+        if (m_Segment == nullptr || m_Index == nullptr)
+        {
+            CloseSegment();
+            return false;
+        }
+
+        //Everything up to the oldest segment kept, including what earlier runs left behind
+        while (m_MaxSegments != 0 && m_SegmentIndex - m_OldestSegmentIndex >= m_MaxSegments)
+        {
+            std::remove(GetSegmentPath(m_OldestSegmentIndex, "hla").c_str());
+            std::remove(GetSegmentPath(m_OldestSegmentIndex, "hli").c_str());
+            m_OldestSegmentIndex++;
+        }
+
+        return true;
+    }
+
+    void ArchiveLogger::CloseSegment()
+    {
+        if (m_Segment)
+            std::fclose(m_Segment);
+        if (m_Index)
+            std::fclose(m_Index);
+
+        m_Segment = nullptr;
+        m_Index = nullptr;
+    }
+
+    std::string ArchiveLogger::GetSegmentPath(unsigned int index, const char *extension) const
+    {
+        return m_BasePath + "." + std::to_string(index) + "." + extension;
+    }
+}
@@ -0,0 +1,128 @@
+#include <hive/precomp.h>
+#include <hive/core/clock.h>
+
+#include <thread>
+
+namespace hive
+{
+    namespace
+    {
+        constexpr std::uint64_t NanosecondsPerSecond = 1000000000;
+        constexpr std::chrono::milliseconds MinCalibrationTime{20};
+
+        std::uint64_t ReadSteadyNanoseconds()
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        std::uint64_t ReadWallNanoseconds()
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        struct ClockAnchor
+        {
+            std::uint64_t ticks;
+            std::uint64_t steadyNanoseconds;
+            std::uint64_t wallNanoseconds;
+        };
+
+        // Pairs a tick count with the middle of the tightest of a few steady_clock brackets, so a preemption between
+        // the reads does not skew the rate
+        ClockAnchor SampleAnchor()
+        {
+            ClockAnchor best{};
+            std::uint64_t bestWidth = ~std::uint64_t{0};
+            for (int i = 0; i < 8; ++i)
+            {
+                const std::uint64_t before = ReadSteadyNanoseconds();
+                const std::uint64_t ticks = ReadClockTicks();
+                const std::uint64_t after = ReadSteadyNanoseconds();
+                if (after - before < bestWidth)
+                {
+                    bestWidth = after - before;
+                    best = {ticks, before + (after - before) / 2, 0};
+                }
+            }
+            best.wallNanoseconds = ReadWallNanoseconds() - (ReadSteadyNanoseconds() - best.steadyNanoseconds);
+            return best;
+        }
+
+        const ClockAnchor &GetAnchor()
+        {
+            static const ClockAnchor anchor = SampleAnchor();
+            return anchor;
+        }
+
+        //Starts the calibration window as early as possible
+        [[maybe_unused]] const ClockAnchor &s_StartupAnchor = GetAnchor();
+
+        struct ClockCalibration
+        {
+            ClockAnchor anchor;
+            std::uint64_t ticksPerSecond;
+        };
+
+        ClockCalibration Calibrate()
+        {
+            const ClockAnchor &anchor = GetAnchor();
+
+            const std::uint64_t minEnd = anchor.steadyNanoseconds + static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(MinCalibrationTime).count());
+            std::uint64_t steadyNow = ReadSteadyNanoseconds();
+            if (steadyNow < minEnd)
+            {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(minEnd - steadyNow));
+            }
+
+            const ClockAnchor end = SampleAnchor();
+            const double ticksPerNanosecond = static_cast<double>(end.ticks - anchor.ticks) /
+                                              static_cast<double>(end.steadyNanoseconds - anchor.steadyNanoseconds);
+            const auto ticksPerSecond = static_cast<std::uint64_t>(ticksPerNanosecond * NanosecondsPerSecond + 0.5);
+            return {anchor, ticksPerSecond > 0 ? ticksPerSecond : 1};
+        }
+
+        const ClockCalibration &GetCalibration()
+        {
+            static const ClockCalibration calibration = Calibrate();
+            return calibration;
+        }
+
+        //Exact integer scaling, a double would lose nanoseconds after a few days of uptime
+        std::uint64_t TicksToNanoseconds(std::uint64_t ticks, std::uint64_t ticksPerSecond)
+        {
+            return ticks / ticksPerSecond * NanosecondsPerSecond +
+                   ticks % ticksPerSecond * NanosecondsPerSecond / ticksPerSecond;
+        }
+    }
+
+    void CalibrateClock()
+    {
+        (void) GetCalibration();
+    }
+
+    std::uint64_t GetClockTicksPerSecond()
+    {
+        return GetCalibration().ticksPerSecond;
+    }
+
+    std::uint64_t ClockTicksToNanoseconds(std::uint64_t ticks)
+    {
+        const ClockCalibration &calibration = GetCalibration();
+        const ClockAnchor &anchor = calibration.anchor;
+
+        //Records can be stamped during static initialization, before the anchor
+        if (ticks >= anchor.ticks)
+            return anchor.steadyNanoseconds + TicksToNanoseconds(ticks - anchor.ticks, calibration.ticksPerSecond);
+
+        return anchor.steadyNanoseconds - TicksToNanoseconds(anchor.ticks - ticks, calibration.ticksPerSecond);
+    }
+
+    std::uint64_t ClockTicksToWallNanoseconds(std::uint64_t ticks)
+    {
+        const ClockAnchor &anchor = GetCalibration().anchor;
+        return anchor.wallNanoseconds + (ClockTicksToNanoseconds(ticks) - anchor.steadyNanoseconds);
+    }
+}
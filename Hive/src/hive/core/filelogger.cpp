@@ -0,0 +1,118 @@
+#include <hive/precomp.h>
+#include <hive/core/filelogger.h>
+#include <hive/core/logformat.h>
+
+#include <cstring>
+#include <thread>
+
+namespace hive
+{
+    FileLogger::FileLogger(LogManager &manager, const FileLoggerConfig &config) : m_Manager(manager),
+        m_BasePath(config.basePath),
+        m_SegmentSize(config.segmentSize),
+        m_MaxSegments(config.maxSegments == 0 ? 1 : config.maxSegments)
+    {
+        if (OpenSegment(0))
+            m_Base.store(m_File.GetData(), std::memory_order_release);
+
+        m_LoggerId = m_Manager.RegisterLogger<&FileLogger::Log>(this, config.logger);
+    }
+
+    FileLogger::~FileLogger()
+    {
+        //Waits for in-flight calls, nothing writes to the mapping afterwards
+        m_Manager.UnregisterLogger(m_LoggerId);
+
+        const std::uint64_t used = m_Cursor.load(std::memory_order_acquire);
+        m_File.Close(used < m_SegmentSize ? used : m_SegmentSize);
+    }
+
+    void FileLogger::Log(const LogRecord &record)
+    {
+        if (!IsOpen())
+            return;
+
+        LogFormatBuffer line;
+        line.Append('[');
+        line.Append(std::string_view{GetSeverityName(record.severity)});
+        line.Append(std::string_view{"] "});
+        line.Append(std::string_view{record.category.GetFullPath()});
+        line.Append(std::string_view{" - "});
+        line.Append(std::string_view{record.message});
+
+        if (record.location.line() != 0)
+        {
+            const std::string_view file = record.location.file_name();
+            line.Append(std::string_view{" ("});
+            line.Append(file.substr(file.find_last_of("/\\") + 1));
+            line.Append(':');
+            line.Append(static_cast<std::uint64_t>(record.location.line()));
+            line.Append(')');
+        }
+        line.Append('\n');
+
+        Append(line.CStr(), line.Size());
+    }
+
+    void FileLogger::Append(const char *data, std::size_t size)
+    {
+        size = size < m_SegmentSize ? size : m_SegmentSize;
+
+        for (;;)
+        {
+            const std::uint32_t generation = m_Generation.load(std::memory_order_acquire);
+            const std::uint64_t offset = m_Cursor.fetch_add(size, std::memory_order_acq_rel);
+
+            if (offset + size <= m_SegmentSize)
+            {
+                std::byte *base = m_Base.load(std::memory_order_acquire);
+                if (base == nullptr)
+                    return;
+
+                std::memcpy(base + offset, data, size);
+                m_Committed.fetch_add(size, std::memory_order_release);
+                return;
+            }
+
+            if (offset <= m_SegmentSize)
+            {
+                //Our reservation crosses the end, so we are the only thread rotating this segment
+                while (m_Committed.load(std::memory_order_acquire) != offset)
+                {
+                    std::this_thread::yield();
+                }
+
+                Rotate(offset);
+                if (!IsOpen())
+                    return;
+                continue;
+            }
+
+            //The segment is full and another thread is rotating it
+            while (m_Generation.load(std::memory_order_acquire) == generation)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void FileLogger::Rotate(std::size_t usedSize)
+    {
+        m_File.Close(usedSize);
+
+        const unsigned int nextIndex = m_SegmentIndex + 1;
+        std::byte *base = OpenSegment(nextIndex) ? m_File.GetData() : nullptr;
+        m_SegmentIndex = nextIndex;
+
+        m_Base.store(base, std::memory_order_release);
+        m_Committed.store(0, std::memory_order_relaxed);
+        m_Cursor.store(0, std::memory_order_release);
+        m_Generation.fetch_add(1, std::memory_order_release);
+    }
+
+    bool FileLogger::OpenSegment(unsigned int index)
+    {
+        const std::string path = m_BasePath + "." + std::to_string(index % m_MaxSegments) + ".log";
+        return m_File.Open(path.c_str(), m_SegmentSize);
+    }
+}
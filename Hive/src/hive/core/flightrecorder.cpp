@@ -0,0 +1,326 @@
+#include <hive/precomp.h>
+#include <hive/core/flightrecorder.h>
+#include <hive/platform/crashhandler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace hive
+{
+    struct FlightRecorder::RegionHeader
+    {
+        char magic[8];
+        std::uint32_t slotSize;
+        std::uint32_t maxThreads;
+        std::uint32_t recordsPerThread;
+        std::atomic<std::uint32_t> threadCount; //Rings handed out at least once, may exceed maxThreads
+        std::atomic<std::uint32_t> unrecordedThreads; //Found every ring in use
+    };
+
+    struct FlightRecorder::Ring
+    {
+        std::atomic<std::uint64_t> writeIndex; //Only advanced by the owning thread
+        std::atomic<bool> isOwned; //Released when the owning thread exits, so pool workers coming and going reuse rings
+        char padding[55]; //Keeps rings of different threads off each other's cache line
+    };
+
+    struct FlightRecorder::Slot
+    {
+        std::uint8_t severity;
+        std::uint8_t categoryLength;
+        std::uint16_t messageLength;
+        char category[60];
+        char message[SlotSize - 64];
+    };
+
+    namespace
+    {
+        constexpr char RegionMagic[8] = {'H', 'I', 'V', 'E', 'F', 'L', 'T', '1'};
+        constexpr std::size_t RegionHeaderSize = 64;
+
+        std::atomic<std::uint64_t> g_NextRecorderId{1};
+        std::atomic<FlightRecorder *> g_CrashRecorder{nullptr};
+
+        // Ids of the recorders alive, so an exiting thread only touches the ring of a recorder still there
+        std::mutex g_LiveRecordersMutex;
+        std::vector<std::uint64_t> g_LiveRecorders;
+
+        struct ThreadRing
+        {
+            ~ThreadRing()
+            {
+                if (ring == nullptr)
+                    return;
+
+                std::lock_guard lock(g_LiveRecordersMutex);
+                if (std::find(g_LiveRecorders.begin(), g_LiveRecorders.end(), recorderId) != g_LiveRecorders.end())
+                    isOwned->store(false, std::memory_order_release);
+            }
+
+            std::uint64_t recorderId{0};
+            void *ring{nullptr};
+            std::atomic<bool> *isOwned{nullptr};
+        };
+
+        thread_local ThreadRing t_Ring;
+
+        std::size_t CopyTruncated(char *destination, std::size_t capacity, std::string_view source)
+        {
+            const std::size_t length = source.size() < capacity ? source.size() : capacity;
+            std::memcpy(destination, source.data(), length);
+            return length;
+        }
+
+        std::size_t CopyTruncated(char *destination, std::size_t capacity, const char *source)
+        {
+            std::size_t length = 0;
+            while (length < capacity && source[length] != '\0')
+            {
+                destination[length] = source[length];
+                length++;
+            }
+            return length;
+        }
+
+        //Line building without snprintf, which is not async-signal-safe
+        class SignalSafeLine
+        {
+        public:
+            void Append(const char *text, std::size_t size)
+            {
+                for (std::size_t i = 0; i < size && m_Size < sizeof(m_Data); ++i)
+                {
+                    m_Data[m_Size++] = text[i];
+                }
+            }
+
+            void Append(const char *text) { Append(text, std::strlen(text)); }
+
+            void Append(std::uint64_t value)
+            {
+                char digits[20];
+                std::size_t count = 0;
+                do
+                {
+                    digits[count++] = static_cast<char>('0' + value % 10);
+                    value /= 10;
+                } while (value != 0);
+
+                while (count > 0)
+                {
+                    Append(&digits[--count], 1);
+                }
+            }
+
+            void WriteTo(int handle) const { CrashOutput::Write(handle, m_Data, m_Size); }
+
+        private:
+            char m_Data[FlightRecorder::SlotSize + 64];
+            std::size_t m_Size{0};
+        };
+    }
+
+    FlightRecorder::FlightRecorder(const FlightRecorderConfig &config) : m_Id(g_NextRecorderId.fetch_add(1)),
+        m_MaxThreads(config.maxThreads),
+        m_RecordsPerThread(config.recordsPerThread == 0 ? 1 : config.recordsPerThread),
+        m_MinSeverity(config.minSeverity),
+        m_DumpPath(config.dumpPath ? config.dumpPath : "")
+    {
+        static_assert(sizeof(Slot) == SlotSize);
+        static_assert(sizeof(RegionHeader) <= RegionHeaderSize);
+
+        const std::size_t ringSize = sizeof(Ring) + m_RecordsPerThread * sizeof(Slot);
+        const std::size_t regionSize = RegionHeaderSize + m_MaxThreads * ringSize;
+
+        if (config.backingPath && m_File.Open(config.backingPath, regionSize))
+        {
+            m_Region = m_File.GetData();
+        }
+        else if (!config.backingPath)
+        {
+            m_Memory = std::make_unique<std::byte[]>(regionSize);
+            m_Region = m_Memory.get();
+        }
+
+        if (m_Region == nullptr)
+            return;
+
+        auto *header = new(m_Region) RegionHeader{};
+        std::memcpy(header->magic, RegionMagic, sizeof(RegionMagic));
+        header->slotSize = SlotSize;
+        header->maxThreads = m_MaxThreads;
+        header->recordsPerThread = m_RecordsPerThread;
+
+        //Owned until first handed out, so only rings released by a thread are ever taken over
+        for (unsigned int i = 0; i < m_MaxThreads; ++i)
+        {
+            new(GetRing(i)) Ring{};
+            GetRing(i)->isOwned.store(true, std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard lock(g_LiveRecordersMutex);
+            g_LiveRecorders.push_back(m_Id);
+        }
+
+        if (config.installCrashHandler)
+        {
+            g_CrashRecorder.store(this, std::memory_order_release);
+            m_HasCrashHandler = InstallCrashHandler(&FlightRecorder::OnCrash);
+        }
+    }
+
+    FlightRecorder::~FlightRecorder()
+    {
+        {
+            std::lock_guard lock(g_LiveRecordersMutex);
+            std::erase(g_LiveRecorders, m_Id);
+        }
+
+        FlightRecorder *expected = this;
+        if (g_CrashRecorder.compare_exchange_strong(expected, nullptr) && m_HasCrashHandler)
+            RemoveCrashHandler();
+    }
+
+    void FlightRecorder::Record(const LogRecord &record)
+    {
+        if (record.severity < m_MinSeverity)
+            return;
+
+        Ring *ring = GetThreadRing();
+        if (ring == nullptr)
+            return;
+
+        const std::uint64_t index = ring->writeIndex.load(std::memory_order_relaxed);
+        Slot *slot = GetSlot(ring, index);
+
+        slot->severity = static_cast<std::uint8_t>(record.severity);
+        slot->categoryLength = static_cast<std::uint8_t>(
+            CopyTruncated(slot->category, sizeof(slot->category), record.category.GetFullPath()));
+        slot->messageLength = static_cast<std::uint16_t>(
+            CopyTruncated(slot->message, sizeof(slot->message), record.message));
+
+        ring->writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    void FlightRecorder::Dump(int handle) const
+    {
+        if (m_Region == nullptr)
+            return;
+
+        const auto *header = reinterpret_cast<const RegionHeader *>(m_Region);
+        const std::uint32_t claimed = header->threadCount.load(std::memory_order_acquire);
+        const std::uint32_t threadCount = claimed < m_MaxThreads ? claimed : m_MaxThreads;
+
+        if (const std::uint32_t unrecorded = header->unrecordedThreads.load(std::memory_order_relaxed); unrecorded > 0)
+        {
+            SignalSafeLine warning;
+            warning.Append("--- flight recorder: ");
+            warning.Append(static_cast<std::uint64_t>(unrecorded));
+            warning.Append(" threads not recorded, all rings were in use ---\n");
+            warning.WriteTo(handle);
+        }
+
+        for (std::uint32_t i = 0; i < threadCount; ++i)
+        {
+            Ring *ring = GetRing(i);
+            const std::uint64_t end = ring->writeIndex.load(std::memory_order_acquire);
+            const std::uint64_t begin = end > m_RecordsPerThread ? end - m_RecordsPerThread : 0;
+
+            SignalSafeLine title;
+            title.Append("--- flight recorder thread ");
+            title.Append(static_cast<std::uint64_t>(i));
+            title.Append(", last ");
+            title.Append(end - begin);
+            title.Append(" records ---\n");
+            title.WriteTo(handle);
+
+            for (std::uint64_t index = begin; index < end; ++index)
+            {
+                const Slot *slot = GetSlot(ring, index);
+                const std::size_t severity = slot->severity <= static_cast<std::uint8_t>(LogSeverity::ERROR)
+                                                 ? slot->severity
+                                                 : 0;
+
+                SignalSafeLine line;
+                line.Append("[");
+                line.Append(GetSeverityName(static_cast<LogSeverity>(severity)));
+                line.Append("] ");
+                line.Append(slot->category, slot->categoryLength <= sizeof(slot->category) ? slot->categoryLength : 0);
+                line.Append(" - ");
+                line.Append(slot->message, slot->messageLength <= sizeof(slot->message) ? slot->messageLength : 0);
+                line.Append("\n");
+                line.WriteTo(handle);
+            }
+        }
+    }
+
+    void FlightRecorder::OnCrash(int signal)
+    {
+        const FlightRecorder *recorder = g_CrashRecorder.load(std::memory_order_acquire);
+        if (recorder == nullptr)
+            return;
+
+        SignalSafeLine banner;
+        banner.Append("*** hive: fatal signal ");
+        banner.Append(static_cast<std::uint64_t>(signal));
+        banner.Append(", dumping log flight recorder\n");
+        banner.WriteTo(CrashOutput::StandardError);
+
+        recorder->Dump(CrashOutput::StandardError);
+
+        if (!recorder->m_DumpPath.empty())
+        {
+            const int handle = CrashOutput::Open(recorder->m_DumpPath.c_str());
+            if (handle >= 0)
+            {
+                banner.WriteTo(handle);
+                recorder->Dump(handle);
+                CrashOutput::Close(handle);
+            }
+        }
+    }
+
+    FlightRecorder::Ring *FlightRecorder::GetThreadRing()
+    {
+        if (t_Ring.recorderId == m_Id)
+            return static_cast<Ring *>(t_Ring.ring);
+
+        auto *header = reinterpret_cast<RegionHeader *>(m_Region);
+        Ring *ring = nullptr;
+
+        //Rings never used first, then those released by threads that exited
+        const std::uint32_t index = header->threadCount.fetch_add(1, std::memory_order_acq_rel);
+        if (index < m_MaxThreads)
+            ring = GetRing(index);
+        for (unsigned int i = 0; ring == nullptr && i < m_MaxThreads; ++i)
+        {
+            bool isOwned = false;
+            if (GetRing(i)->isOwned.compare_exchange_strong(isOwned, true, std::memory_order_acquire))
+                ring = GetRing(i);
+        }
+
+        if (ring == nullptr)
+            header->unrecordedThreads.fetch_add(1, std::memory_order_relaxed);
+
+        t_Ring.recorderId = m_Id;
+        t_Ring.ring = ring;
+        t_Ring.isOwned = ring ? &ring->isOwned : nullptr;
+        return ring;
+    }
+
+    FlightRecorder::Ring *FlightRecorder::GetRing(unsigned int index) const
+    {
+        const std::size_t ringSize = sizeof(Ring) + m_RecordsPerThread * sizeof(Slot);
+        return reinterpret_cast<Ring *>(m_Region + RegionHeaderSize + index * ringSize);
+    }
+
+    FlightRecorder::Slot *FlightRecorder::GetSlot(Ring *ring, std::uint64_t index) const
+    {
+        auto *slots = reinterpret_cast<Slot *>(reinterpret_cast<std::byte *>(ring) + sizeof(Ring));
+        return &slots[index % m_RecordsPerThread];
+    }
+}
@@ -1,65 +1,616 @@
 #include <hive/precomp.h>
 #include <hive/core/log.h>
+#include <hive/core/flightrecorder.h>
+#include <hive/core/logdeferred.h>
+#include <hive/core/logfilter.h>
+#include <hive/core/logratelimit.h>
+#include <hive/utils/ringbuffer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <thread>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
 
-#include <iostream>
 namespace hive
 {
-    const LogCategory LogHiveRoot { "Hive" };
+    constinit const LogCategory LogHiveRoot { "Hive" };
+
+    namespace
+    {
+        constexpr std::size_t AsyncRecordSize = 256;
+
+        // Fixed-size record so a push is a single slot claim plus a bounded copy
+        struct AsyncLogRecord
+        {
+            static constexpr std::size_t MaxMessageSize = AsyncRecordSize - sizeof(const LogCategory *) -
+                                                          sizeof(LogSeverity) - sizeof(std::source_location) -
+                                                          sizeof(std::uint64_t);
+
+            const LogCategory *category;
+            LogSeverity severity;
+            std::source_location location;
+            std::uint64_t timestamp;
+            char message[MaxMessageSize];
+        };
+    }
+
+    // Queue plus thread delivering to target. The LogManager's shared writer also drains the deferred buffers and
+    // passes itself as deferredSource.
+    class AsyncLogWriter
+    {
+    public:
+        AsyncLogWriter(const LogAsyncConfig &config, const LogManager::LogCallback &target,
+                       const LogManager::FlushCallback &flush, LogManager *deferredSource = nullptr) : m_Target(target),
+            m_FlushTarget(flush),
+            m_DeferredSource(deferredSource),
+            m_Policy(config.overflowPolicy),
+            m_Queue(config.capacity),
+            m_Thread(&AsyncLogWriter::Run, this)
+        {
+        }
+
+        ~AsyncLogWriter()
+        {
+            m_Running.store(false, std::memory_order_release);
+            m_Thread.join();
+        }
+
+        void Enqueue(const LogRecord &source)
+        {
+            const std::size_t length = std::strlen(source.message);
+            const bool isTruncated = length >= AsyncLogRecord::MaxMessageSize;
+            const std::size_t copyLength = isTruncated ? AsyncLogRecord::MaxMessageSize - 1 : length;
+
+            const auto writeRecord = [&](AsyncLogRecord &record)
+            {
+                record.category = &source.category;
+                record.severity = source.severity;
+                record.location = source.location;
+                record.timestamp = source.timestamp;
+                std::memcpy(record.message, source.message, copyLength);
+                record.message[copyLength] = '\0';
+            };
+
+            if (isTruncated)
+                m_Truncated.fetch_add(1, std::memory_order_relaxed);
+
+            if (m_Queue.TryEmplace(writeRecord))
+                return;
+
+            switch (m_Policy)
+            {
+                case LogOverflowPolicy::DROP:
+                    m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case LogOverflowPolicy::BLOCK:
+                    while (!m_Queue.TryEmplace(writeRecord))
+                    {
+                        std::this_thread::yield();
+                    }
+                    break;
+                case LogOverflowPolicy::OVERWRITE_OLDEST:
+                    while (!m_Queue.TryEmplace(writeRecord))
+                    {
+                        if (m_Queue.TryDiscard())
+                            m_Overwritten.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+            }
+        }
+
+        void Flush() const
+        {
+            const std::size_t target = m_Queue.GetEnqueuePosition();
+            while (m_Completed.load(std::memory_order_acquire) < target)
+            {
+                std::this_thread::yield();
+            }
+
+            if (m_DeferredSource)
+                DeferredLogRegistry::Get().WaitUntilDrained();
+        }
+
+        [[nodiscard]] LogAsyncStats GetStats() const
+        {
+            return {
+                m_Written.load(std::memory_order_relaxed),
+                m_Dropped.load(std::memory_order_relaxed),
+                m_Overwritten.load(std::memory_order_relaxed),
+                m_Truncated.load(std::memory_order_relaxed),
+                m_DeferredSource ? DeferredLogRegistry::Get().GetDroppedCount() : 0
+            };
+        }
+
+    private:
+        void Run()
+        {
+            unsigned int idleRounds = 0;
+            while (m_Running.load(std::memory_order_acquire))
+            {
+                if (Drain() > 0)
+                {
+                    idleRounds = 0;
+                    continue;
+                }
+
+                //Stay responsive for bursts, then back off so an idle writer does not burn a core
+                if (++idleRounds < 64)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+
+            Drain();
+        }
+
+        std::size_t Drain()
+        {
+            std::size_t count = 0;
+            const auto dispatchRecord = [this](AsyncLogRecord &record)
+            {
+                m_Target({*record.category, record.severity, record.message, record.location, record.timestamp});
+            };
+
+            while (m_Queue.TryConsume(dispatchRecord))
+            {
+                count++;
+            }
+
+            if (m_DeferredSource)
+                count += m_DeferredSource->DrainDeferredBuffers();
+
+            if (count > 0 && !m_FlushTarget.empty())
+                m_FlushTarget();
+
+            // Everything below the dequeue position was either written by us or discarded by an overwriting producer
+            m_Written.store(m_Written.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+            m_Completed.store(m_Queue.GetDequeuePosition(), std::memory_order_release);
+            return count;
+        }
+
+        const LogManager::LogCallback m_Target;
+        const LogManager::FlushCallback m_FlushTarget;
+        LogManager *const m_DeferredSource;
+        const LogOverflowPolicy m_Policy;
+        MpscRingBuffer<AsyncLogRecord> m_Queue;
+
+        std::atomic<bool> m_Running{true};
+        std::atomic<std::size_t> m_Completed{0};
+
+        std::atomic<std::uint64_t> m_Written{0};
+        std::atomic<std::uint64_t> m_Dropped{0};
+        std::atomic<std::uint64_t> m_Overwritten{0};
+        std::atomic<std::uint64_t> m_Truncated{0};
+
+        std::thread m_Thread; //Last so the thread starts once everything else is constructed
+    };
+
+    LogManager::LogManager() = default;
+
+    LogManager::~LogManager()
+    {
+        StopAsync();
+        DisableFlightRecorder();
+
+        //Loggers still registered no longer receive anything
+        const auto loggers = m_Loggers.Read();
+        for (const LoggerEntry &entry : *loggers)
+        {
+            detail::RemoveLogSink(entry.category, entry.minSeverity);
+        }
+        SetBinaryLogFile(nullptr);
+    }
+
+    bool LogManager::LoggerEntry::Accepts(const LogRecord &record) const
+    {
+        if (record.severity < minSeverity)
+            return false;
+
+        for (const LogCategory *it = &record.category; it != nullptr; it = it->GetParentCategory())
+        {
+            if (it == category)
+                return true;
+        }
+        return category == nullptr;
+    }
+
+    LogManager::LoggerId LogManager::RegisterCallback(const LogCallback &callback, const FlushCallback &flush,
+                                                      const LoggerConfig &config)
+    {
+        const LoggerId id = ++m_IdCount;
+
+        std::shared_ptr<AsyncLogWriter> writer;
+        if (config.delivery == LogDelivery::DEDICATED)
+            writer = std::make_shared<AsyncLogWriter>(config.queue, callback, flush);
+
+        m_Loggers.Update([&](std::vector<LoggerEntry> &loggers)
+        {
+            loggers.push_back({id, callback, flush, config.minSeverity, config.category, config.delivery, writer});
+        });
+        detail::AddLogSink(config.category, config.minSeverity);
+        return id;
+    }
 
     void LogManager::UnregisterLogger(LoggerId id)
     {
-        const auto isLoggerWithId = [id](const auto &loggerPair)
+        const auto isLoggerWithId = [id](const LoggerEntry &entry)
+        {
+            return entry.id == id;
+        };
+
+        std::optional<LoggerEntry> removed;
+        m_Loggers.Update([&](std::vector<LoggerEntry> &loggers)
+        {
+            const auto it = std::find_if(loggers.begin(), loggers.end(), isLoggerWithId);
+            if (it == loggers.end())
+                return;
+
+            removed = *it;
+            loggers.erase(it);
+        });
+
+        //After the list no longer holds it, so categories never reject what a listed logger accepts
+        if (removed)
+            detail::RemoveLogSink(removed->category, removed->minSeverity);
+    }
+
+    void LogManager::Log(const LogRecord &record)
+    {
+        if (m_FlightRecorder)
+            m_FlightRecorder->Record(record);
+
+        if (!record.category.IsLoggerEnabled(record.severity))
+            return;
+
+        Dispatch(record, m_AsyncWriter ? DispatchScope::PRODUCER : DispatchScope::ALL);
+    }
+
+    void LogManager::StartAsync(const LogAsyncConfig &config)
+    {
+        if (m_AsyncWriter)
+            return;
+
+        m_AsyncWriter = std::make_unique<AsyncLogWriter>(config, LogCallback::Bind<&LogManager::DispatchShared>(this),
+                                                         FlushCallback::Bind<&LogManager::FlushLoggers>(this), this);
+    }
+
+    void LogManager::StopAsync()
+    {
+        //Reported while loggers are still attached, usually the last chance before shutdown
+        ReportSuppressedLogs(*this);
+
+        //The writer drains the queue before joining
+        m_AsyncWriter.reset();
+    }
+
+    void LogManager::FlushLoggers()
+    {
+        //Dedicated loggers are flushed by their own thread
+        const auto flushLogger = [](const LoggerEntry &entry)
         {
-            return loggerPair.first == id;
+            if (entry.delivery != LogDelivery::DEDICATED && !entry.flush.empty())
+                entry.flush();
         };
 
-        auto it = std::find_if(m_Loggers.begin(), m_Loggers.begin() + m_Count, isLoggerWithId);
+        const auto loggers = m_Loggers.Read();
+        std::for_each(loggers->begin(), loggers->end(), flushLogger);
+    }
+
+    bool LogManager::EnableFlightRecorder(const FlightRecorderConfig &config)
+    {
+        DisableFlightRecorder();
+
+        auto recorder = std::make_unique<FlightRecorder>(config);
+        if (!recorder->IsValid())
+            return false;
+
+        m_FlightRecorder = std::move(recorder);
+        SetLogCaptureLevel(config.minSeverity);
+        return true;
+    }
+
+    void LogManager::DisableFlightRecorder()
+    {
+        if (!m_FlightRecorder)
+            return;
+
+        SetLogCaptureLevel(std::nullopt);
+        m_FlightRecorder.reset();
+    }
+
+    void LogManager::Flush()
+    {
+        ReportSuppressedLogs(*this);
+
+        if (m_AsyncWriter)
+            m_AsyncWriter->Flush();
+
+        //After the shared writer, which may have queued deferred records for the dedicated loggers
+        const auto loggers = m_Loggers.Read();
+        for (const LoggerEntry &entry : *loggers)
+        {
+            if (entry.writer)
+                entry.writer->Flush();
+        }
+
+        if (m_BinaryLogFile)
+            m_BinaryLogFile->Flush();
+
+        m_FlushEvent.Broadcast();
+    }
+
+    void LogManager::SetBinaryLogFile(BinaryLogFile *file)
+    {
+        //Takes every record that passes the category levels, like a logger without filter
+        if (file && !m_BinaryLogFile)
+            detail::AddLogSink(nullptr, LogSeverity::TRACE);
+        else if (!file && m_BinaryLogFile)
+            detail::RemoveLogSink(nullptr, LogSeverity::TRACE);
+
+        m_BinaryLogFile = file;
+    }
+
+    LogAsyncStats LogManager::GetAsyncStats() const
+    {
+        if (m_AsyncWriter)
+            return m_AsyncWriter->GetStats();
 
-        const bool isLoggerFound = it != m_Loggers.end();
-        if (isLoggerFound)
+        LogAsyncStats stats{};
+        stats.deferredDropped = DeferredLogRegistry::Get().GetDroppedCount();
+        return stats;
+    }
+
+    LogAsyncStats LogManager::GetLoggerStats(LoggerId id) const
+    {
+        const auto loggers = m_Loggers.Read();
+        for (const LoggerEntry &entry : *loggers)
         {
-            *it = m_Loggers[m_Count - 1];
-            m_Count--;
+            if (entry.id != id)
+                continue;
+
+            if (entry.writer)
+                return entry.writer->GetStats();
+            if (entry.delivery == LogDelivery::SHARED && m_AsyncWriter)
+                return m_AsyncWriter->GetStats();
+            break;
         }
+        return {};
+    }
+
+    void LogManager::SubmitDeferred(DeferredLogBuffer &buffer)
+    {
+        if (m_AsyncWriter)
+            return;
+
+        DrainDeferred(buffer);
     }
 
-    void LogManager::Log(const LogCategory &cat, LogSeverity sev, const char *msg)
+    std::size_t LogManager::DrainDeferred(DeferredLogBuffer &buffer)
     {
-        const auto callLoggerFunc = [&](auto &loggerPair)
+        const auto handleEntry = [this](const DeferredLogEntry &entry, const std::byte *args)
         {
-            loggerPair.second(cat, sev, msg);
+            const auto severity = static_cast<LogSeverity>(entry.severity);
+            const bool isLoggerEnabled = entry.category->IsLoggerEnabled(severity);
+
+            if (m_BinaryLogFile)
+            {
+                if (isLoggerEnabled)
+                    m_BinaryLogFile->Write(entry, args);
+                return;
+            }
+
+            thread_local LogFormatBuffer formatBuffer;
+            formatBuffer.Clear();
+            FormatDeferredMessage(formatBuffer, entry.format, args, entry.argCount);
+
+            const LogRecord record{*entry.category, severity, formatBuffer.CStr(), {}, entry.timestamp};
+            if (m_FlightRecorder)
+                m_FlightRecorder->Record(record);
+
+            if (isLoggerEnabled)
+                Dispatch(record, DispatchScope::ALL);
         };
 
-        std::for_each(m_Loggers.begin(), m_Loggers.begin() + m_Count, callLoggerFunc);
+        return buffer.Consume(handleEntry);
     }
 
-    ConsoleLogger::ConsoleLogger(LogManager &manager) : m_Manager(manager),
-                                                        m_LoggerId(m_Manager.RegisterLogger(this, &ConsoleLogger::Log))
+    std::size_t LogManager::DrainDeferredBuffers()
+    {
+        std::size_t count = 0;
+        DeferredLogRegistry::Get().ForEach([this, &count](DeferredLogBuffer &buffer)
+        {
+            count += DrainDeferred(buffer);
+        });
+        return count;
+    }
+
+    void LogManager::Dispatch(const LogRecord &record, DispatchScope scope)
+    {
+        bool isSharedQueued = false;
+
+        const auto loggers = m_Loggers.Read();
+        for (const LoggerEntry &entry : *loggers)
+        {
+            if (!entry.Accepts(record))
+                continue;
+
+            if (scope == DispatchScope::SHARED_ONLY)
+            {
+                if (entry.delivery == LogDelivery::SHARED)
+                    entry.callback(record);
+                continue;
+            }
+
+            switch (entry.delivery)
+            {
+                case LogDelivery::INLINE:
+                    entry.callback(record);
+                    break;
+                case LogDelivery::SHARED:
+                    if (scope == DispatchScope::PRODUCER)
+                        isSharedQueued = true;
+                    else
+                        entry.callback(record);
+                    break;
+                case LogDelivery::DEDICATED:
+                    entry.writer->Enqueue(record);
+                    break;
+            }
+        }
+
+        //Queued once whatever the number of shared loggers
+        if (isSharedQueued)
+            m_AsyncWriter->Enqueue(record);
+    }
+
+    void LogManager::DispatchShared(const LogRecord &record)
+    {
+        Dispatch(record, DispatchScope::SHARED_ONLY);
+    }
+
+    namespace
+    {
+        // Straight to the standard output descriptor, bypassing the stdio buffer and its lock
+        void WriteStandardOutput(const char *data, std::size_t size)
+        {
+            while (size > 0)
+            {
+#if defined(_WIN32)
+                const int written = _write(1, data, static_cast<unsigned int>(size));
+#else
+                const ssize_t written = write(STDOUT_FILENO, data, size);
+                if (written < 0 && errno == EINTR)
+                    continue;
+#endif
+                if (written <= 0)
+                    return;
+
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+        }
+
+        // Output of one thread waiting to be written to stdout in a single call
+        struct ConsoleBatch
+        {
+            static constexpr std::size_t Capacity = 8 * 1024;
+
+            ~ConsoleBatch()
+            {
+                Write();
+            }
+
+            void Append(std::string_view text)
+            {
+                if (size + text.size() > Capacity)
+                    Write();
+
+                std::memcpy(data + size, text.data(), text.size());
+                size += text.size();
+            }
+
+            void Write()
+            {
+                if (size == 0)
+                    return;
+
+                WriteStandardOutput(data, size);
+                size = 0;
+            }
+
+            char data[Capacity];
+            std::size_t size{0};
+        };
+
+        thread_local ConsoleBatch t_ConsoleBatch;
+
+        constexpr std::array<std::string_view, 4> SeverityColors = {"\x1b[90m", "\x1b[32m", "\x1b[33m", "\x1b[31m"};
+        constexpr std::string_view ColorReset = "\x1b[0m";
+
+        void AppendTwoDigits(LogFormatBuffer &buffer, std::uint64_t value)
+        {
+            buffer.Append(static_cast<char>('0' + value / 10 % 10));
+            buffer.Append(static_cast<char>('0' + value % 10));
+        }
+    }
+
+    ConsoleLogger::ConsoleLogger(LogManager &manager, const ConsoleLoggerConfig &config) : m_Manager(manager),
+        m_Config(config),
+        m_LoggerId(m_Manager.RegisterLogger<&ConsoleLogger::Log, &ConsoleLogger::Flush>(this, config.logger))
     {
     }
 
     ConsoleLogger::~ConsoleLogger()
     {
         m_Manager.UnregisterLogger(m_LoggerId);
+        Flush();
     }
 
-    void ConsoleLogger::Log(const LogCategory &category, LogSeverity severity, const char *message)
+    void ConsoleLogger::Log(const LogRecord &record)
     {
-        //TODO use array instead for better performance
-        static const std::unordered_map<LogSeverity, const char*> severityLabels = {
-            {LogSeverity::TRACE, "[TRACE] "},
-            {LogSeverity::INFO,  "[INFO] "},
-            {LogSeverity::WARN,  "[WARN] "},
-            {LogSeverity::ERROR, "[ERROR] "}
-        };
+        const auto severityIndex = static_cast<std::size_t>(record.severity);
 
-        // Print severity label
-        auto it = severityLabels.find(severity);
-        // HIVE_ASSERT(it != severityLabels.end());
+        LogFormatBuffer line;
+        if (m_Config.showTimestamp)
+        {
+            const std::uint64_t microseconds = ClockTicksToWallNanoseconds(record.timestamp) / 1000;
+            const std::uint64_t seconds = microseconds / 1000000;
+
+            AppendTwoDigits(line, seconds / 3600 % 24);
+            line.Append(':');
+            AppendTwoDigits(line, seconds / 60 % 60);
+            line.Append(':');
+            AppendTwoDigits(line, seconds % 60);
+            line.Append('.');
+            AppendTwoDigits(line, microseconds / 10000);
+            AppendTwoDigits(line, microseconds / 100);
+            AppendTwoDigits(line, microseconds);
+            line.Append(' ');
+        }
 
-        std::cout << it->second;
+        if (m_Config.useColors)
+            line.Append(SeverityColors[severityIndex]);
 
-        // Print categories using STL
-        std::cout << category.GetFullPath() << " - " << message << std::endl;
+        line.Append('[');
+        line.Append(std::string_view{GetSeverityName(record.severity)});
+        line.Append(']');
+
+        if (m_Config.useColors)
+            line.Append(ColorReset);
+
+        line.Append(' ');
+        line.Append(std::string_view{record.category.GetFullPath()});
+        line.Append(std::string_view{" - "});
+        line.Append(std::string_view{record.message});
+
+        if (m_Config.showLocation && record.location.line() != 0)
+        {
+            const std::string_view file = record.location.file_name();
+            line.Append(std::string_view{" ("});
+            line.Append(file.substr(file.find_last_of("/\\") + 1));
+            line.Append(':');
+            line.Append(static_cast<std::uint64_t>(record.location.line()));
+            line.Append(')');
+        }
+        line.Append('\n');
+
+        t_ConsoleBatch.Append(line.View());
+
+        if (record.severity >= LogSeverity::ERROR)
+            t_ConsoleBatch.Write();
+    }
+
+    void ConsoleLogger::Flush()
+    {
+        t_ConsoleBatch.Write();
     }
 }
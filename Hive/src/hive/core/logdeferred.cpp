@@ -0,0 +1,242 @@
+#include <hive/precomp.h>
+#include <hive/core/logdeferred.h>
+
+#include <thread>
+
+namespace hive
+{
+    namespace
+    {
+        // Owned by thread_local storage so the buffer is handed back to the writer when the thread exits
+        struct ThreadDeferredLogBuffer
+        {
+            std::shared_ptr<DeferredLogBuffer> buffer;
+
+            ~ThreadDeferredLogBuffer()
+            {
+                if (buffer)
+                    buffer->Abandon();
+            }
+        };
+
+        template<typename T>
+        T ReadPayload(const std::byte *&cursor)
+        {
+            T value;
+            std::memcpy(&value, cursor, sizeof(T));
+            cursor += sizeof(T);
+            return value;
+        }
+    }
+
+    DeferredLogRegistry &DeferredLogRegistry::Get()
+    {
+        static DeferredLogRegistry registry;
+        return registry;
+    }
+
+    DeferredLogBuffer &DeferredLogRegistry::GetThreadBuffer()
+    {
+        thread_local ThreadDeferredLogBuffer threadBuffer{Get().Register()};
+        return *threadBuffer.buffer;
+    }
+
+    std::shared_ptr<DeferredLogBuffer> DeferredLogRegistry::Register()
+    {
+        auto buffer = std::make_shared<DeferredLogBuffer>();
+
+        std::lock_guard lock(m_Mutex);
+        m_Buffers.push_back(buffer);
+        return buffer;
+    }
+
+    void DeferredLogRegistry::WaitUntilDrained()
+    {
+        std::vector<std::pair<std::shared_ptr<DeferredLogBuffer>, std::size_t>> targets;
+        {
+            std::lock_guard lock(m_Mutex);
+            for (const auto &buffer : m_Buffers)
+            {
+                targets.emplace_back(buffer, buffer->GetWritePosition());
+            }
+        }
+
+        for (const auto &[buffer, position] : targets)
+        {
+            while (buffer->GetReadPosition() < position)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::uint64_t DeferredLogRegistry::GetDroppedCount()
+    {
+        std::lock_guard lock(m_Mutex);
+
+        std::uint64_t dropped = m_ReleasedDropped;
+        for (const auto &buffer : m_Buffers)
+        {
+            dropped += buffer->GetDroppedCount();
+        }
+        return dropped;
+    }
+
+    void FormatDeferredMessage(LogFormatBuffer &buffer, std::string_view format, const std::byte *args, std::size_t argCount)
+    {
+        const std::byte *cursor = args;
+
+        //Arguments are consumed in order, so decode lazily as placeholders are reached
+        const auto appendArg = [&](LogFormatBuffer &out, std::size_t /*index*/)
+        {
+            switch (static_cast<LogArgType>(*cursor++))
+            {
+                case LogArgType::BOOL:
+                    out.Append(ReadPayload<char>(cursor) != 0);
+                    break;
+                case LogArgType::CHAR:
+                    out.Append(ReadPayload<char>(cursor));
+                    break;
+                case LogArgType::INT:
+                    out.Append(ReadPayload<std::int64_t>(cursor));
+                    break;
+                case LogArgType::UINT:
+                    out.Append(ReadPayload<std::uint64_t>(cursor));
+                    break;
+                case LogArgType::FLOAT:
+                    out.Append(ReadPayload<double>(cursor));
+                    break;
+                case LogArgType::POINTER:
+                    out.Append(reinterpret_cast<const void *>(ReadPayload<std::uint64_t>(cursor)));
+                    break;
+                case LogArgType::STRING:
+                {
+                    const auto size = ReadPayload<std::uint32_t>(cursor);
+                    out.Append(std::string_view{reinterpret_cast<const char *>(cursor), size});
+                    cursor += size;
+                    break;
+                }
+            }
+        };
+
+        FormatLogMessage(buffer, format, argCount, appendArg);
+    }
+
+    bool IsValidDeferredArgs(const std::byte *args, std::size_t size, std::size_t argCount)
+    {
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < argCount; i++)
+        {
+            if (offset >= size)
+                return false;
+
+            std::size_t payloadSize;
+            switch (static_cast<LogArgType>(args[offset++]))
+            {
+                case LogArgType::BOOL:
+                case LogArgType::CHAR:
+                    payloadSize = 1;
+                    break;
+                case LogArgType::INT:
+                case LogArgType::UINT:
+                case LogArgType::FLOAT:
+                case LogArgType::POINTER:
+                    payloadSize = 8;
+                    break;
+                case LogArgType::STRING:
+                {
+                    if (size - offset < sizeof(std::uint32_t))
+                        return false;
+
+                    std::uint32_t stringSize;
+                    std::memcpy(&stringSize, args + offset, sizeof(stringSize));
+                    offset += sizeof(stringSize);
+                    payloadSize = stringSize;
+                    break;
+                }
+                default:
+                    return false;
+            }
+
+            if (size - offset < payloadSize)
+                return false;
+            offset += payloadSize;
+        }
+        return true;
+    }
+
+    BinaryLogFile::~BinaryLogFile()
+    {
+        Close();
+    }
+
+    bool BinaryLogFile::Open(const char *path)
+    {
+        Close();
+
+        std::lock_guard lock(m_Mutex);
+        m_File = std::fopen(path, "wb");
+        if (m_File == nullptr)
+            return false;
+
+        std::fwrite(Magic, sizeof(Magic), 1, m_File);
+        return true;
+    }
+
+    void BinaryLogFile::Close()
+    {
+        std::lock_guard lock(m_Mutex);
+        if (m_File == nullptr)
+            return;
+
+        std::fclose(m_File);
+        m_File = nullptr;
+        m_KnownFormats.clear();
+        m_KnownCategories.clear();
+    }
+
+    void BinaryLogFile::Flush()
+    {
+        std::lock_guard lock(m_Mutex);
+        if (m_File)
+            std::fflush(m_File);
+    }
+
+    void BinaryLogFile::Write(const DeferredLogEntry &entry, const std::byte *args)
+    {
+        std::lock_guard lock(m_Mutex);
+        if (m_File == nullptr)
+            return;
+
+        if (m_KnownFormats.insert(entry.format).second)
+            WriteDefinition(Tag::FORMAT, reinterpret_cast<std::uint64_t>(entry.format), entry.format);
+
+        const std::uint32_t categoryId = entry.category->GetId();
+        if (categoryId >= m_KnownCategories.size())
+            m_KnownCategories.resize(categoryId + 1);
+        if (!m_KnownCategories[categoryId])
+        {
+            m_KnownCategories[categoryId] = true;
+            WriteDefinition(Tag::CATEGORY, categoryId, entry.category->GetFullPath());
+        }
+
+        const auto argSize = static_cast<std::uint32_t>(entry.size - sizeof(DeferredLogEntry));
+
+        WriteValue(Tag::MESSAGE);
+        WriteValue(ClockTicksToNanoseconds(entry.timestamp));
+        WriteValue(entry.severity);
+        WriteValue(static_cast<std::uint64_t>(categoryId));
+        WriteValue(reinterpret_cast<std::uint64_t>(entry.format));
+        WriteValue(entry.argCount);
+        WriteValue(argSize);
+        std::fwrite(args, argSize, 1, m_File);
+    }
+
+    void BinaryLogFile::WriteDefinition(Tag tag, std::uint64_t id, std::string_view text)
+    {
+        WriteValue(tag);
+        WriteValue(id);
+        WriteValue(static_cast<std::uint32_t>(text.size()));
+        std::fwrite(text.data(), text.size(), 1, m_File);
+    }
+}
@@ -0,0 +1,354 @@
+#include <hive/precomp.h>
+#include <hive/core/logfilter.h>
+
+#include <cctype>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+
+namespace hive
+{
+    namespace
+    {
+        constexpr std::uint8_t LevelOff = static_cast<std::uint8_t>(LogSeverity::ERROR) + 1;
+
+        std::string_view Trim(std::string_view text)
+        {
+            const auto first = text.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos)
+                return {};
+
+            const auto last = text.find_last_not_of(" \t\r");
+            return text.substr(first, last - first + 1);
+        }
+
+        // Lets the level map be searched with the string_view paths of the categories
+        struct PathHash
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view path) const
+            {
+                return std::hash<std::string_view>{}(path);
+            }
+        };
+
+        std::optional<std::uint8_t> ParseLevel(std::string_view text)
+        {
+            constexpr std::array<std::string_view, LevelOff + 1> names = {"TRACE", "INFO", "WARN", "ERROR", "OFF"};
+
+            const auto equalsIgnoreCase = [text](std::string_view name)
+            {
+                return std::equal(text.begin(), text.end(), name.begin(), name.end(), [](char a, char b)
+                {
+                    return std::toupper(static_cast<unsigned char>(a)) == b;
+                });
+            };
+
+            const auto it = std::find_if(names.begin(), names.end(), equalsIgnoreCase);
+            if (it == names.end())
+                return std::nullopt;
+
+            return static_cast<std::uint8_t>(it - names.begin());
+        }
+    }
+
+    // Owns the configured levels and the list of live categories
+    class LogCategoryRegistry
+    {
+    public:
+        static LogCategoryRegistry &Get()
+        {
+            // Never destroyed: categories are constant initialized, so they are destroyed after any function local
+            // static and still unregister themselves
+            static auto *registry = new LogCategoryRegistry;
+            return *registry;
+        }
+
+        void Add(const LogCategory &category)
+        {
+            if (category.m_ParentCategory)
+                category.m_ParentCategory->EnsureRegistered();
+
+            std::lock_guard lock(m_Mutex);
+            if (category.m_Id.load(std::memory_order_relaxed) != LogCategory::InvalidId)
+                return;
+
+            ComposePath(category);
+
+            category.m_NextCategory = m_Head;
+            m_Head = &category;
+            Resolve(category);
+
+            category.m_Id.store(m_CategoryCount.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+        }
+
+        void Remove(const LogCategory &category)
+        {
+            if (category.m_Id.load(std::memory_order_acquire) == LogCategory::InvalidId)
+                return;
+
+            std::lock_guard lock(m_Mutex);
+            for (const LogCategory **it = &m_Head; *it != nullptr; it = &(*it)->m_NextCategory)
+            {
+                if (*it == &category)
+                {
+                    *it = category.m_NextCategory;
+                    break;
+                }
+            }
+        }
+
+        void SetDefault(std::uint8_t level)
+        {
+            std::lock_guard lock(m_Mutex);
+            m_DefaultLevel = level;
+            ResolveAll();
+        }
+
+        void Set(std::string_view path, std::optional<std::uint8_t> level)
+        {
+            std::lock_guard lock(m_Mutex);
+            const auto it = m_Levels.find(path);
+            if (!level)
+            {
+                if (it != m_Levels.end())
+                    m_Levels.erase(it);
+            }
+            else if (it != m_Levels.end())
+                it->second = *level;
+            else
+                m_Levels.emplace(path, *level);
+            ResolveAll();
+        }
+
+        void SetCapture(std::uint8_t level)
+        {
+            std::lock_guard lock(m_Mutex);
+            m_CaptureLevel = level;
+            ResolveAll();
+        }
+
+        void Clear()
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Levels.clear();
+            ResolveAll();
+        }
+
+        void AddSink(const LogCategory *category, std::uint8_t level)
+        {
+            if (category)
+                category->EnsureRegistered();
+
+            std::lock_guard lock(m_Mutex);
+            m_Sinks.push_back({category, level});
+            ResolveAll();
+        }
+
+        void RemoveSink(const LogCategory *category, std::uint8_t level)
+        {
+            std::lock_guard lock(m_Mutex);
+            const auto it = std::find(m_Sinks.begin(), m_Sinks.end(), Sink{category, level});
+            if (it != m_Sinks.end())
+                m_Sinks.erase(it);
+            ResolveAll();
+        }
+
+        [[nodiscard]] std::uint32_t GetCategoryCount() const
+        {
+            return m_CategoryCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+        // The parent is registered first, so its path is complete
+        static void ComposePath(const LogCategory &category)
+        {
+            std::string_view parentPath;
+            if (category.m_ParentCategory)
+                parentPath = {category.m_ParentCategory->m_FullPath, category.m_ParentCategory->m_FullPathLength};
+
+            std::size_t length = 0;
+            const auto append = [&](std::string_view text)
+            {
+                const std::size_t count = std::min(text.size(), LogCategory::MaxPathLength - 1 - length);
+                std::copy_n(text.data(), count, category.m_FullPath + length);
+                length += count;
+            };
+
+            if (!parentPath.empty())
+            {
+                append(parentPath);
+                append("/");
+            }
+            append(category.m_Name);
+
+            category.m_FullPath[length] = '\0';
+            category.m_FullPathLength = length;
+        }
+
+        void ResolveAll()
+        {
+            for (const LogCategory *category = m_Head; category != nullptr; category = category->m_NextCategory)
+            {
+                Resolve(*category);
+            }
+        }
+
+        void Resolve(const LogCategory &category) const
+        {
+            std::uint8_t level = m_DefaultLevel;
+            for (const LogCategory *it = &category; it != nullptr; it = it->GetParentCategory())
+            {
+                const auto levelIt = m_Levels.find(std::string_view{it->m_FullPath, it->m_FullPathLength});
+                if (levelIt != m_Levels.end())
+                {
+                    level = levelIt->second;
+                    break;
+                }
+            }
+
+            //Raised to the lowest severity a logger covering the category accepts, OFF without any
+            std::uint8_t sinkLevel = LevelOff;
+            for (const Sink &sink : m_Sinks)
+            {
+                if (sink.level < sinkLevel && IsInSubtree(category, sink.category))
+                    sinkLevel = sink.level;
+            }
+            level = level > sinkLevel ? level : sinkLevel;
+
+            category.m_LoggerSeverity.store(level, std::memory_order_relaxed);
+            category.m_MinSeverity.store(level < m_CaptureLevel ? level : m_CaptureLevel, std::memory_order_relaxed);
+        }
+
+        struct Sink
+        {
+            const LogCategory *category;
+            std::uint8_t level;
+
+            bool operator==(const Sink &other) const = default;
+        };
+
+        static bool IsInSubtree(const LogCategory &category, const LogCategory *root)
+        {
+            if (root == nullptr)
+                return true;
+
+            for (const LogCategory *it = &category; it != nullptr; it = it->GetParentCategory())
+            {
+                if (it == root)
+                    return true;
+            }
+            return false;
+        }
+
+        std::mutex m_Mutex;
+        const LogCategory *m_Head{nullptr};
+        std::atomic<std::uint32_t> m_CategoryCount{0};
+        std::unordered_map<std::string, std::uint8_t, PathHash, std::equal_to<>> m_Levels;
+        std::uint8_t m_DefaultLevel{static_cast<std::uint8_t>(LogSeverity::TRACE)};
+        std::uint8_t m_CaptureLevel{LevelOff};
+        std::vector<Sink> m_Sinks;
+    };
+
+    void detail::AddLogSink(const LogCategory *category, LogSeverity minSeverity)
+    {
+        LogCategoryRegistry::Get().AddSink(category, static_cast<std::uint8_t>(minSeverity));
+    }
+
+    void detail::RemoveLogSink(const LogCategory *category, LogSeverity minSeverity)
+    {
+        LogCategoryRegistry::Get().RemoveSink(category, static_cast<std::uint8_t>(minSeverity));
+    }
+
+    void LogCategory::Register() const
+    {
+        LogCategoryRegistry::Get().Add(*this);
+    }
+
+    LogCategory::~LogCategory()
+    {
+        LogCategoryRegistry::Get().Remove(*this);
+    }
+
+    std::uint32_t GetLogCategoryCount()
+    {
+        return LogCategoryRegistry::Get().GetCategoryCount();
+    }
+
+    void SetDefaultLogLevel(LogSeverity severity)
+    {
+        LogCategoryRegistry::Get().SetDefault(static_cast<std::uint8_t>(severity));
+    }
+
+    void SetLogLevel(std::string_view categoryPath, LogSeverity severity)
+    {
+        LogCategoryRegistry::Get().Set(categoryPath, static_cast<std::uint8_t>(severity));
+    }
+
+    void DisableLogCategory(std::string_view categoryPath)
+    {
+        LogCategoryRegistry::Get().Set(categoryPath, LevelOff);
+    }
+
+    void ResetLogLevel(std::string_view categoryPath)
+    {
+        LogCategoryRegistry::Get().Set(categoryPath, std::nullopt);
+    }
+
+    void ResetLogLevels()
+    {
+        LogCategoryRegistry::Get().Clear();
+    }
+
+    void SetLogCaptureLevel(std::optional<LogSeverity> severity)
+    {
+        LogCategoryRegistry::Get().SetCapture(severity ? static_cast<std::uint8_t>(*severity) : LevelOff);
+    }
+
+    bool ApplyLogConfig(std::string_view config)
+    {
+        bool isValid = true;
+
+        while (!config.empty())
+        {
+            const auto lineEnd = config.find('\n');
+            std::string_view line = config.substr(0, lineEnd);
+            config = lineEnd == std::string_view::npos ? std::string_view{} : config.substr(lineEnd + 1);
+
+            line = Trim(line.substr(0, line.find('#')));
+            if (line.empty())
+                continue;
+
+            const auto separator = line.find('=');
+            const std::string_view path = Trim(line.substr(0, separator));
+            const std::optional<std::uint8_t> level = separator == std::string_view::npos
+                                                          ? std::nullopt
+                                                          : ParseLevel(Trim(line.substr(separator + 1)));
+            if (path.empty() || !level)
+            {
+                isValid = false;
+                continue;
+            }
+
+            if (path == "default")
+                LogCategoryRegistry::Get().SetDefault(*level);
+            else
+                LogCategoryRegistry::Get().Set(path, *level);
+        }
+
+        return isValid;
+    }
+
+    bool LoadLogConfig(const char *path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+
+        std::stringstream content;
+        content << file.rdbuf();
+        return ApplyLogConfig(content.str());
+    }
+}
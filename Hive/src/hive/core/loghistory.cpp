@@ -0,0 +1,105 @@
+#include <hive/precomp.h>
+#include <hive/core/loghistory.h>
+
+#include <cstring>
+
+namespace hive
+{
+    namespace
+    {
+        std::size_t RoundUpPow2(std::size_t value)
+        {
+            std::size_t result = 2;
+            while (result < value)
+                result <<= 1;
+            return result;
+        }
+    }
+
+    LogHistory::LogHistory(LogManager &manager, const LogHistoryConfig &config) : m_Manager(manager),
+        m_SlotMask(RoundUpPow2(config.recordCapacity) - 1),
+        m_TextMask(RoundUpPow2(config.textCapacity > MaxMessageLength ? config.textCapacity : MaxMessageLength) - 1),
+        m_Slots(std::make_unique<Slot[]>(m_SlotMask + 1)),
+        m_Text(std::make_unique<char[]>(m_TextMask + 1))
+    {
+        m_LoggerId = m_Manager.RegisterLogger<&LogHistory::Log>(this, config.logger);
+    }
+
+    LogHistory::~LogHistory()
+    {
+        m_Manager.UnregisterLogger(m_LoggerId);
+    }
+
+    void LogHistory::Log(const LogRecord &record)
+    {
+        const std::size_t length = strnlen(record.message, MaxMessageLength);
+
+        const std::uint64_t sequence = m_Head.fetch_add(1, std::memory_order_relaxed);
+        const std::uint64_t offset = m_TextHead.fetch_add(length, std::memory_order_relaxed);
+
+        Slot &slot = m_Slots[sequence & m_SlotMask];
+        slot.version.store(2 * sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.category = &record.category;
+        slot.timestamp = record.timestamp;
+        slot.textOffset = offset;
+        slot.textLength = static_cast<std::uint16_t>(length);
+        slot.severity = record.severity;
+
+        //The message may wrap around the end of the ring
+        const std::size_t start = offset & m_TextMask;
+        const std::size_t firstPart = length < m_TextMask + 1 - start ? length : m_TextMask + 1 - start;
+        std::memcpy(m_Text.get() + start, record.message, firstPart);
+        std::memcpy(m_Text.get(), record.message + firstPart, length - firstPart);
+
+        slot.version.store(2 * sequence + 2, std::memory_order_release);
+    }
+
+    bool LogHistory::TryRead(std::uint64_t sequence, const LogHistoryQuery &query, LogHistoryEntry &entry,
+                             LogFormatBuffer &message) const
+    {
+        const Slot &slot = m_Slots[sequence & m_SlotMask];
+        const std::uint64_t version = slot.version.load(std::memory_order_acquire);
+        if (version != 2 * sequence + 2)
+            return false;
+
+        entry = {sequence, slot.category, slot.severity, slot.timestamp, {}};
+        const std::uint64_t offset = slot.textOffset;
+        const std::size_t length = slot.textLength;
+
+        //Cheap rejections first, the text is only copied for matching records
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != version)
+            return false;
+
+        if (entry.severity < query.minSeverity || entry.timestamp < query.fromTimestamp ||
+            entry.timestamp > query.toTimestamp)
+            return false;
+
+        if (query.category)
+        {
+            const LogCategory *category = entry.category;
+            while (category != nullptr && category != query.category)
+                category = category->GetParentCategory();
+
+            if (category == nullptr)
+                return false;
+        }
+
+        const std::size_t start = offset & m_TextMask;
+        const std::size_t firstPart = length < m_TextMask + 1 - start ? length : m_TextMask + 1 - start;
+        message.Clear();
+        message.Append(std::string_view{m_Text.get() + start, firstPart});
+        message.Append(std::string_view{m_Text.get(), length - firstPart});
+
+        //Overwritten while we copied: either the slot was reused or newer messages reached our bytes
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != version ||
+            m_TextHead.load(std::memory_order_relaxed) > offset + m_TextMask + 1)
+            return false;
+
+        entry.message = message.View();
+        return true;
+    }
+}
@@ -0,0 +1,86 @@
+#include <hive/precomp.h>
+#include <hive/core/logratelimit.h>
+
+#include <mutex>
+
+namespace hive
+{
+    namespace
+    {
+        // Limiters that dropped messages. Never destroyed, static limiters may unlist themselves after main.
+        struct SuppressingLimiters
+        {
+            std::mutex mutex;
+            std::vector<LogRateLimiter *> limiters;
+        };
+
+        SuppressingLimiters &GetSuppressingLimiters()
+        {
+            static auto *limiters = new SuppressingLimiters;
+            return *limiters;
+        }
+    }
+
+    LogRateLimiter::~LogRateLimiter()
+    {
+        if (!m_IsListed.load(std::memory_order_acquire))
+            return;
+
+        SuppressingLimiters &listed = GetSuppressingLimiters();
+        std::lock_guard lock(listed.mutex);
+        std::erase(listed.limiters, this);
+    }
+
+    void LogRateLimiter::List(const LogCategory &cat, LogSeverity sev, const std::source_location &location,
+                              std::string_view format)
+    {
+        if (m_IsListed.exchange(true, std::memory_order_acq_rel))
+            return;
+
+        SuppressingLimiters &listed = GetSuppressingLimiters();
+        std::lock_guard lock(listed.mutex);
+        m_Category = &cat;
+        m_Severity = sev;
+        m_Location = location;
+        m_Format = format;
+        listed.limiters.push_back(this);
+    }
+
+    void ReportSuppressedLogs(LogManager &manager)
+    {
+        struct Report
+        {
+            const LogCategory *category;
+            LogSeverity severity;
+            std::source_location location;
+            std::string_view format;
+            std::uint32_t count;
+        };
+
+        //Logged after unlocking, a logger may itself hit a limiter
+        std::vector<Report> reports;
+        {
+            SuppressingLimiters &listed = GetSuppressingLimiters();
+            std::lock_guard lock(listed.mutex);
+            for (LogRateLimiter *limiter : listed.limiters)
+            {
+                if (const std::uint32_t count = limiter->TakeSuppressedCount(); count > 0)
+                {
+                    reports.push_back({limiter->m_Category, limiter->m_Severity, limiter->m_Location,
+                                       limiter->m_Format, count});
+                }
+            }
+        }
+
+        for (const Report &report : reports)
+        {
+            LogFormatBuffer buffer;
+            buffer.Append(std::string_view{"Suppressed "});
+            buffer.Append(static_cast<std::uint64_t>(report.count));
+            buffer.Append(std::string_view{" repeats of \""});
+            buffer.Append(report.format);
+            buffer.Append('"');
+            manager.Log({*report.category, report.severity, buffer.CStr(), report.location});
+        }
+    }
+}
@@ -1,34 +1,78 @@
 #include <hive/precomp.h>
 #include <hive/core/module.h>
+#include <hive/core/allocationcounter.h>
+#include <hive/core/clock.h>
+
+#include <atomic>
 
 namespace hive
 {
+    namespace
+    {
+        std::uint32_t GetThreadIndex()
+        {
+            static std::atomic<std::uint32_t> s_ThreadCount{0};
+            thread_local const std::uint32_t index = s_ThreadCount.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+
+        class ScopedPhaseTiming
+        {
+        public:
+            explicit ScopedPhaseTiming(ModulePhaseTiming &timing) : m_Timing(timing),
+                m_StartAllocationCount(GetThreadAllocationCount())
+            {
+                m_Timing.threadIndex = GetThreadIndex();
+                m_Timing.startTicks = ReadClockTicks();
+            }
+
+            ~ScopedPhaseTiming()
+            {
+                m_Timing.endTicks = ReadClockTicks();
+                m_Timing.allocationCount = GetThreadAllocationCount() - m_StartAllocationCount;
+                m_Timing.hasRun = true;
+            }
+
+        private:
+            ModulePhaseTiming &m_Timing;
+            std::uint64_t m_StartAllocationCount;
+        };
+    }
+
     void Module::Configure()
     {
+        ScopedPhaseTiming timing(m_PhaseTimings[static_cast<std::size_t>(ModulePhase::CONFIGURE)]);
         DoConfigure(m_Context);
     }
 
     void Module::Initialize()
     {
+        ScopedPhaseTiming timing(m_PhaseTimings[static_cast<std::size_t>(ModulePhase::INITIALIZE)]);
         DoInitialize();
+        m_IsInitialized = true;
     }
 
-    void Module::Shutdown()
+    bool Module::Tick(TickPhase phase, double deltaSeconds, std::chrono::microseconds budget)
     {
-        DoShutdown();
+        const std::uint64_t start = ReadClockTicks();
+        DoTick(phase, deltaSeconds);
+        const std::uint64_t microseconds = (ClockTicksToNanoseconds(ReadClockTicks()) -
+                                            ClockTicksToNanoseconds(start)) / 1000;
+
+        ModuleTickStats &stats = m_TickStats[static_cast<std::size_t>(phase)];
+        const bool isOverBudget = microseconds > static_cast<std::uint64_t>(budget.count());
+        stats.tickCount++;
+        stats.overrunCount += isOverBudget ? 1 : 0;
+        stats.lastMicroseconds = microseconds;
+        stats.maxMicroseconds = microseconds > stats.maxMicroseconds ? microseconds : stats.maxMicroseconds;
+        stats.totalMicroseconds += microseconds;
+        return isOverBudget;
     }
 
-    bool Module::CanInitialize(const std::unordered_set<std::string> &initModulesNames) const
+    void Module::Shutdown()
     {
-        int depCount {0};
-        for (auto depName : m_Context.GetDependencies())
-        {
-            if (initModulesNames.find(depName) != initModulesNames.end())
-            {
-                depCount++;
-            }
-        }
-
-        return depCount == m_Context.GetDependencies().size();
+        ScopedPhaseTiming timing(m_PhaseTimings[static_cast<std::size_t>(ModulePhase::SHUTDOWN)]);
+        DoShutdown();
+        m_IsInitialized = false;
     }
 }
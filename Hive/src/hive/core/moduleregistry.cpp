@@ -1,8 +1,38 @@
 #include <hive/precomp.h>
 #include <hive/core/moduleregistry.h>
+#include <hive/core/allocationcounter.h>
+#include <hive/core/clock.h>
+#include <hive/core/logratelimit.h>
+#include <hive/core/modulelibrary.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string_view>
 
 namespace hive
 {
+    constinit const LogCategory LogHiveModule { "Module", &LogHiveRoot };
+
+    namespace
+    {
+        constexpr const char *PhaseNames[] = {"Configure", "Initialize", "Shutdown"};
+        constexpr const char *TickPhaseNames[] = {"PreUpdate", "Update", "PostUpdate", "Render"};
+    }
+
+    ModuleRegistry::~ModuleRegistry()
+    {
+        if (m_ModuleLibraries.empty())
+            return;
+
+        //Library code must stay loaded while the modules are destroyed and their last records are written
+        m_Modules.clear();
+        FlushLogsBeforeUnload();
+    }
+
     void ModuleRegistry::RegisterModule(ModuleFactoryFn fn)
     {
         m_ModuleFactories.push_back(fn);
@@ -17,59 +47,708 @@ namespace hive
 
         std::for_each(m_ModuleFactories.begin(), m_ModuleFactories.end(), createModuleFromFactory);    }
 
-    void ModuleRegistry::ConfigureModules()
+    bool ModuleRegistry::ConfigureModules()
     {
         std::for_each(m_Modules.begin(), m_Modules.end(),
               [](auto &module)
               { module->Configure(); });
 
-        std::unordered_set<std::string> initializedModules;
-        std::vector<std::unique_ptr<Module>> orderedModules;
+        m_IsConfigured = true;
+        return OrderModules();
+    }
+
+    bool ModuleRegistry::OrderModules()
+    {
+        m_ConfigureErrors.clear();
+        const std::size_t count = m_Modules.size();
 
-        std::vector<std::unique_ptr<Module>> remainingModules = std::move(m_Modules);
+        std::unordered_map<std::string_view, std::size_t> indices;
+        indices.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!indices.emplace(m_Modules[i]->GetName(), i).second)
+                m_ConfigureErrors.push_back(std::string{"Module "} + m_Modules[i]->GetName() + " is registered twice");
+        }
 
-        while (!remainingModules.empty())
+        //Names are resolved once, the sort itself only works on indices
+        std::vector<std::vector<std::size_t>> dependencies(count);
+        std::vector<std::vector<std::size_t>> dependents(count);
+        std::vector<std::uint32_t> pendingDependencies(count, 0);
+        for (std::size_t i = 0; i < count; ++i)
         {
-            const auto canModuleInitialize = [&initializedModules](const auto &module)
+            for (const std::string &dependency : m_Modules[i]->GetDependencies())
             {
-                return module->CanInitialize(initializedModules);
-            };
+                //A missing dependency is never satisfied, which keeps the module and its dependents out of the order
+                pendingDependencies[i]++;
 
-            auto it = std::find_if(
-                remainingModules.begin(),
-                remainingModules.end(),
-                canModuleInitialize);
+                const auto it = indices.find(dependency);
+                if (it == indices.end())
+                {
+                    m_ConfigureErrors.push_back(std::string{"Module "} + m_Modules[i]->GetName() + " depends on " +
+                                                dependency + " which is not registered");
+                    continue;
+                }
 
-            if (it == remainingModules.end())
+                dependencies[i].push_back(it->second);
+                dependents[it->second].push_back(i);
+            }
+        }
+
+        //Kahn's algorithm, order doubles as the queue
+        std::vector<std::size_t> order;
+        order.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (pendingDependencies[i] == 0)
+                order.push_back(i);
+        }
+        for (std::size_t head = 0; head < order.size(); ++head)
+        {
+            for (const std::size_t dependent : dependents[order[head]])
             {
-                return;
+                if (--pendingDependencies[dependent] == 0)
+                    order.push_back(dependent);
             }
+        }
 
-            initializedModules.insert((*it)->GetName());
-            orderedModules.push_back(std::move(*it));
-            remainingModules.erase(it);
+        if (order.size() != count)
+            ReportUnorderedModules(dependencies, pendingDependencies);
+
+        for (const std::string &error : m_ConfigureErrors)
+        {
+            if (HasService<LogManager>())
+                LogError(LogHiveModule, "{}", error);
+        }
+
+        std::vector<std::size_t> positions(count, count);
+        std::vector<std::unique_ptr<Module>> orderedModules;
+        orderedModules.reserve(order.size());
+        for (const std::size_t index : order)
+        {
+            positions[index] = orderedModules.size();
+            orderedModules.push_back(std::move(m_Modules[index]));
+        }
+
+        //Modules left out are destroyed, which after a reload may include modules that were running
+        for (std::size_t i = count; i-- > 0;)
+        {
+            if (positions[i] == count && m_Modules[i]->IsInitialized())
+            {
+                m_ModuleShutdown.Broadcast(*m_Modules[i]);
+                m_Modules[i]->Shutdown();
+            }
+        }
+
+        m_InitGraph.modules.resize(order.size());
+        m_InitGraph.dependents.assign(order.size(), {});
+        m_InitGraph.dependencyCounts.assign(order.size(), 0);
+        std::vector<std::vector<std::size_t>> orderedDependencies(order.size());
+        for (const std::size_t index : order)
+        {
+            const std::size_t position = positions[index];
+            m_InitGraph.modules[position] = position;
+            m_InitGraph.dependencyCounts[position] = static_cast<std::uint32_t>(dependencies[index].size());
+            for (const std::size_t dependent : dependents[index])
+            {
+                //Left out when it also waits on a missing or cyclic module
+                if (positions[dependent] != count)
+                    m_InitGraph.dependents[position].push_back(positions[dependent]);
+            }
+            for (const std::size_t dependency : dependencies[index])
+            {
+                orderedDependencies[position].push_back(positions[dependency]);
+            }
         }
 
         m_Modules = std::move(orderedModules);
+        BuildTickGraphs(orderedDependencies);
+        return m_ConfigureErrors.empty();
+    }
+
+    void ModuleRegistry::BuildTickGraphs(const std::vector<std::vector<std::size_t>> &dependencies)
+    {
+        for (std::size_t phaseIndex = 0; phaseIndex < static_cast<std::size_t>(TickPhase::COUNT); ++phaseIndex)
+        {
+            const auto phase = static_cast<TickPhase>(phaseIndex);
+            ModuleGraph &graph = m_TickGraphs[phaseIndex];
+            graph = {};
+
+            //Closest ticking modules each module depends on, looking through the ones not ticking in this phase
+            std::vector<std::vector<std::size_t>> tickingDependencies(m_Modules.size());
+            std::vector<std::size_t> nodes(m_Modules.size());
+            for (std::size_t i = 0; i < m_Modules.size(); ++i)
+            {
+                std::vector<std::size_t> &closest = tickingDependencies[i];
+                for (const std::size_t dependency : dependencies[i])
+                {
+                    if (m_Modules[dependency]->HasTickPhase(phase))
+                        closest.push_back(dependency);
+                    else
+                        closest.insert(closest.end(), tickingDependencies[dependency].begin(),
+                                       tickingDependencies[dependency].end());
+                }
+                std::sort(closest.begin(), closest.end());
+                closest.erase(std::unique(closest.begin(), closest.end()), closest.end());
+
+                if (!m_Modules[i]->HasTickPhase(phase))
+                    continue;
+
+                nodes[i] = graph.modules.size();
+                graph.modules.push_back(i);
+                graph.dependents.emplace_back();
+                graph.dependencyCounts.push_back(static_cast<std::uint32_t>(closest.size()));
+                for (const std::size_t dependency : closest)
+                {
+                    graph.dependents[nodes[dependency]].push_back(nodes[i]);
+                }
+            }
+        }
+    }
+
+    void ModuleRegistry::ReportUnorderedModules(const std::vector<std::vector<std::size_t>> &dependencies,
+                                                const std::vector<std::uint32_t> &pendingDependencies)
+    {
+        enum class Visit : std::uint8_t
+        {
+            NONE, IN_PROGRESS, DONE
+        };
+
+        //Depth first over the unordered modules, a dependency still in progress closes a cycle. The stack holds a
+        //chain of modules each depending on the next one.
+        std::vector<Visit> visits(dependencies.size(), Visit::NONE);
+        std::vector<std::pair<std::size_t, std::size_t>> stack; //Module, next dependency to visit
+        for (std::size_t root = 0; root < dependencies.size(); ++root)
+        {
+            if (pendingDependencies[root] == 0 || visits[root] != Visit::NONE)
+                continue;
+
+            visits[root] = Visit::IN_PROGRESS;
+            stack.emplace_back(root, 0);
+            while (!stack.empty())
+            {
+                auto &[module, next] = stack.back();
+                if (next == dependencies[module].size())
+                {
+                    visits[module] = Visit::DONE;
+                    stack.pop_back();
+                    continue;
+                }
+
+                const std::size_t dependency = dependencies[module][next++];
+                if (visits[dependency] == Visit::NONE)
+                {
+                    visits[dependency] = Visit::IN_PROGRESS;
+                    stack.emplace_back(dependency, 0);
+                }
+                else if (visits[dependency] == Visit::IN_PROGRESS)
+                {
+                    std::string cycle = m_Modules[dependency]->GetName();
+                    auto it = std::find_if(stack.begin(), stack.end(),
+                                           [dependency](const auto &entry) { return entry.first == dependency; });
+                    for (++it; it != stack.end(); ++it)
+                    {
+                        cycle = cycle + " -> " + m_Modules[it->first]->GetName();
+                    }
+                    m_ConfigureErrors.push_back("Module dependency cycle: " + cycle + " -> " +
+                                                m_Modules[dependency]->GetName());
+                }
+            }
+        }
+
+        std::string skipped;
+        for (std::size_t i = 0; i < dependencies.size(); ++i)
+        {
+            if (pendingDependencies[i] != 0)
+                skipped = skipped + (skipped.empty() ? "" : ", ") + m_Modules[i]->GetName();
+        }
+        m_ConfigureErrors.push_back("Modules left uninitialized: " + skipped);
     }
 
     void ModuleRegistry::InitModules()
     {
-        const auto moduleInit = [](const auto &module)
+        const auto moduleInit = [this](const auto &module)
         {
             module->Initialize();
+            m_ModuleInitialized.Broadcast(*module);
         };
 
         std::for_each(m_Modules.begin(), m_Modules.end(), moduleInit);
+        m_IsInitialized = true;
+    }
+
+    void ModuleRegistry::InitModulesParallel(unsigned int workerCount)
+    {
+        RunInDependencyOrder(m_InitGraph, &GetThreadPool(workerCount), [this](Module &module)
+        {
+            module.Initialize();
+            m_ModuleInitialized.Broadcast(module);
+        });
+        m_IsInitialized = true;
+    }
+
+    void ModuleRegistry::SetTickConfig(const ModuleTickConfig &config)
+    {
+        m_TickConfig = config;
+    }
+
+    void ModuleRegistry::TickModules(double deltaSeconds)
+    {
+        for (std::size_t phaseIndex = 0; phaseIndex < static_cast<std::size_t>(TickPhase::COUNT); ++phaseIndex)
+        {
+            const ModuleGraph &graph = m_TickGraphs[phaseIndex];
+            if (graph.modules.empty())
+                continue;
+
+            ThreadPool *pool = m_TickConfig.isParallel ? &GetThreadPool(m_TickConfig.workerCount) : nullptr;
+            const auto phase = static_cast<TickPhase>(phaseIndex);
+            RunInDependencyOrder(graph, pool, [this, phase, deltaSeconds](Module &module)
+            {
+                const std::chrono::microseconds budget = module.GetTickBudget(phase).count() != 0
+                                                             ? module.GetTickBudget(phase)
+                                                             : m_TickConfig.defaultBudget;
+                if (module.Tick(phase, deltaSeconds, budget))
+                {
+                    const ModuleTickStats &stats = module.GetTickStats(phase);
+                    LogRateLimited(stats.overrunLimiter, LogHiveModule, LogSeverity::WARN,
+                                   "{} {} tick took {} us, budget {} us", module.GetName(),
+                                   TickPhaseNames[static_cast<std::size_t>(phase)], stats.lastMicroseconds,
+                                   static_cast<std::uint64_t>(budget.count()));
+                }
+            });
+        }
+    }
+
+    void ModuleRegistry::LogTickSummary() const
+    {
+        for (std::size_t phaseIndex = 0; phaseIndex < static_cast<std::size_t>(TickPhase::COUNT); ++phaseIndex)
+        {
+            for (const std::size_t index : m_TickGraphs[phaseIndex].modules)
+            {
+                const Module &module = *m_Modules[index];
+                const ModuleTickStats &stats = module.GetTickStats(static_cast<TickPhase>(phaseIndex));
+                if (stats.tickCount == 0)
+                    continue;
+
+                LogInfo(LogHiveModule, "{} {}: {} ticks, average {} us, worst {} us, {} over budget", module.GetName(),
+                        TickPhaseNames[phaseIndex], stats.tickCount, stats.totalMicroseconds / stats.tickCount,
+                        stats.maxMicroseconds, stats.overrunCount);
+            }
+        }
+    }
+
+    ThreadPool &ModuleRegistry::GetThreadPool(unsigned int workerCount)
+    {
+        if (!m_ThreadPool || (workerCount != 0 && m_ThreadPool->GetThreadCount() != workerCount))
+            m_ThreadPool = std::make_unique<ThreadPool>(workerCount);
+
+        return *m_ThreadPool;
+    }
+
+    void ModuleRegistry::RunInDependencyOrder(const ModuleGraph &graph, ThreadPool *pool,
+                                              const MoveOnlyFunctor<void(Module &)> &run)
+    {
+        if (pool == nullptr)
+        {
+            for (const std::size_t index : graph.modules)
+            {
+                run(*m_Modules[index]);
+            }
+            return;
+        }
+
+        const std::size_t count = graph.modules.size();
+        std::vector<std::atomic<std::uint32_t>> pendingDependencies(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            pendingDependencies[i].store(graph.dependencyCounts[i], std::memory_order_relaxed);
+        }
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<std::size_t> mainThreadQueue;
+        std::size_t remaining = count;
+
+        //Mutually recursive: finishing a module schedules the dependents it was the last dependency of
+        std::function<void(std::size_t)> schedule;
+        const auto execute = [&](std::size_t index)
+        {
+            run(*m_Modules[graph.modules[index]]);
+
+            for (const std::size_t dependent : graph.dependents[index])
+            {
+                if (pendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    schedule(dependent);
+            }
+
+            //Notified under the lock, the waiting thread may destroy everything as soon as it is released
+            std::lock_guard lock(mutex);
+            remaining--;
+            changed.notify_all();
+        };
+        schedule = [&](std::size_t index)
+        {
+            if (m_Modules[graph.modules[index]]->IsMainThreadRequired())
+            {
+                std::lock_guard lock(mutex);
+                mainThreadQueue.push_back(index);
+                changed.notify_all();
+            }
+            else
+            {
+                pool->Submit([&execute, index] { execute(index); });
+            }
+        };
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (graph.dependencyCounts[i] == 0)
+                schedule(i);
+        }
+
+        std::unique_lock lock(mutex);
+        while (true)
+        {
+            changed.wait(lock, [&] { return remaining == 0 || !mainThreadQueue.empty(); });
+            if (mainThreadQueue.empty())
+                break;
+
+            const std::size_t index = mainThreadQueue.back();
+            mainThreadQueue.pop_back();
+
+            lock.unlock();
+            execute(index);
+            lock.lock();
+        }
+    }
+
+    namespace
+    {
+
+        std::uint64_t GetDurationMicroseconds(const ModulePhaseTiming &timing)
+        {
+            return (ClockTicksToNanoseconds(timing.endTicks) - ClockTicksToNanoseconds(timing.startTicks)) / 1000;
+        }
+    }
+
+    bool ModuleRegistry::WriteTimingTrace(const char *path) const
+    {
+        std::FILE *file = std::fopen(path, "w");
+        if (file == nullptr)
+            return false;
+
+        std::uint64_t origin = ~std::uint64_t{0};
+        for (const auto &module : m_Modules)
+        {
+            for (std::size_t phase = 0; phase < static_cast<std::size_t>(ModulePhase::COUNT); ++phase)
+            {
+                const ModulePhaseTiming &timing = module->GetPhaseTiming(static_cast<ModulePhase>(phase));
+                if (timing.hasRun && timing.startTicks < origin)
+                    origin = timing.startTicks;
+            }
+        }
+        const std::uint64_t originNanoseconds = ClockTicksToNanoseconds(origin);
+
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        bool isFirst = true;
+        for (const auto &module : m_Modules)
+        {
+            for (std::size_t phase = 0; phase < static_cast<std::size_t>(ModulePhase::COUNT); ++phase)
+            {
+                const ModulePhaseTiming &timing = module->GetPhaseTiming(static_cast<ModulePhase>(phase));
+                if (!timing.hasRun)
+                    continue;
+
+                //Module names are identifiers, nothing to escape
+                const double start = static_cast<double>(ClockTicksToNanoseconds(timing.startTicks) -
+                                                         originNanoseconds) / 1e3;
+                std::fprintf(file,
+                             "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                             "\"pid\":1,\"tid\":%u,\"args\":{\"allocations\":%llu}}",
+                             isFirst ? "" : ",", module->GetName(), PhaseNames[phase], start,
+                             static_cast<double>(ClockTicksToNanoseconds(timing.endTicks) -
+                                                 ClockTicksToNanoseconds(timing.startTicks)) / 1e3,
+                             timing.threadIndex,
+                             static_cast<unsigned long long>(timing.allocationCount));
+                isFirst = false;
+            }
+        }
+        std::fprintf(file, "\n]}\n");
+
+        return std::fclose(file) == 0;
+    }
+
+    void ModuleRegistry::LogTimingSummary() const
+    {
+        const std::size_t count = m_Modules.size();
+        if (count == 0)
+            return;
+
+        std::vector<std::uint64_t> durations(count);
+        std::uint64_t firstStart = ~std::uint64_t{0};
+        std::uint64_t lastEnd = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const ModulePhaseTiming &timing = m_Modules[i]->GetPhaseTiming(ModulePhase::INITIALIZE);
+            if (!timing.hasRun)
+                continue;
+
+            durations[i] = GetDurationMicroseconds(timing);
+            firstStart = timing.startTicks < firstStart ? timing.startTicks : firstStart;
+            lastEnd = timing.endTicks > lastEnd ? timing.endTicks : lastEnd;
+        }
+
+        //Longest chain of initialize durations, m_Modules is already in dependency order. Without ConfigureModules
+        //there is no graph, and every module is its own chain.
+        std::vector<std::uint64_t> chainDurations = durations;
+        std::vector<std::size_t> chainPrevious(count, count);
+        for (std::size_t i = 0; i < m_InitGraph.dependents.size(); ++i)
+        {
+            for (const std::size_t dependent : m_InitGraph.dependents[i])
+            {
+                if (chainDurations[i] + durations[dependent] > chainDurations[dependent])
+                {
+                    chainDurations[dependent] = chainDurations[i] + durations[dependent];
+                    chainPrevious[dependent] = i;
+                }
+            }
+        }
+
+        std::vector<std::size_t> bySlowest(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            bySlowest[i] = i;
+        }
+        std::sort(bySlowest.begin(), bySlowest.end(),
+                  [&durations](std::size_t a, std::size_t b) { return durations[a] > durations[b]; });
+
+        const char *allocationsNote = IsAllocationTrackingEnabled() ? "" : " (allocation tracking disabled)";
+        LogInfo(LogHiveModule, "Module initialization, slowest first{}:", allocationsNote);
+        for (const std::size_t index : bySlowest)
+        {
+            const Module &module = *m_Modules[index];
+            const ModulePhaseTiming &configure = module.GetPhaseTiming(ModulePhase::CONFIGURE);
+            const ModulePhaseTiming &initialize = module.GetPhaseTiming(ModulePhase::INITIALIZE);
+            LogInfo(LogHiveModule, "  {} init {} us, {} allocations, thread {}, configure {} us", module.GetName(),
+                    durations[index], initialize.allocationCount, initialize.threadIndex,
+                    GetDurationMicroseconds(configure));
+        }
+
+        std::size_t last = 0;
+        for (std::size_t i = 1; i < count; ++i)
+        {
+            if (chainDurations[i] > chainDurations[last])
+                last = i;
+        }
+
+        std::string path = m_Modules[last]->GetName();
+        for (std::size_t i = chainPrevious[last]; i != count; i = chainPrevious[i])
+        {
+            path = std::string{m_Modules[i]->GetName()} + " -> " + path;
+        }
+
+        const std::uint64_t wallTime = lastEnd > firstStart
+                                           ? (ClockTicksToNanoseconds(lastEnd) - ClockTicksToNanoseconds(firstStart)) / 1000
+                                           : 0;
+        LogInfo(LogHiveModule, "Critical path {} us of {} us initializing: {}", chainDurations[last], wallTime,
+                std::string_view{path});
     }
 
     void ModuleRegistry::ShutdownModules()
     {
-        const auto moduleShutdown = [](const auto &module)
+        const auto moduleShutdown = [this](const auto &module)
         {
+            m_ModuleShutdown.Broadcast(*module);
             module->Shutdown();
         };
 
         std::for_each(m_Modules.rbegin(), m_Modules.rend(), moduleShutdown);
+        m_IsInitialized = false;
+    }
+
+    bool ModuleRegistry::LoadModuleLibrary(const char *path)
+    {
+        std::unique_ptr<ModuleLibrary> library = OpenModuleLibrary(path, 0);
+        if (!library)
+            return false;
+
+        std::unique_ptr<Module> module{library->create()};
+        std::string name = module->GetName();
+        if (m_ModuleLibraries.contains(name) || FindModule(name) != m_Modules.size())
+        {
+            LogError(LogHiveModule, "Module {} from {} is already loaded", std::string_view{name}, path);
+            return false;
+        }
+
+        m_ModuleLibraries.emplace(std::move(name), std::move(library));
+        m_Modules.push_back(std::move(module));
+
+        //Loaded at runtime, catch up with the others
+        if (m_IsConfigured)
+        {
+            m_Modules.back()->Configure();
+            OrderModules();
+        }
+        if (m_IsInitialized)
+            InitPendingModules();
+
+        return true;
+    }
+
+    bool ModuleRegistry::ReloadModule(std::string_view moduleName)
+    {
+        //Copied, the caller may pass the name of the module about to be unloaded
+        const std::string name{moduleName};
+        const auto libraryIt = m_ModuleLibraries.find(name);
+        if (libraryIt == m_ModuleLibraries.end())
+        {
+            LogError(LogHiveModule, "Module {} was not loaded from a library", std::string_view{name});
+            return false;
+        }
+
+        //The new version is loaded next to the old one, so a failed build leaves the running module untouched
+        std::unique_ptr<ModuleLibrary> library = OpenModuleLibrary(libraryIt->second->path.c_str(),
+                                                                   libraryIt->second->generation + 1);
+        if (!library)
+            return false;
+
+        std::unique_ptr<Module> module{library->create()};
+        if (name != module->GetName())
+        {
+            LogError(LogHiveModule, "Reloaded {} provides module {} instead of {}",
+                     std::string_view{library->path}, module->GetName(), std::string_view{name});
+            return false;
+        }
+
+        Module *reloaded = module.get();
+        const std::size_t index = FindModule(name);
+        if (index != m_Modules.size())
+        {
+            ShutdownWithDependents(index);
+            m_Modules[index] = std::move(module);
+        }
+        else
+        {
+            //Left out by a previous ordering
+            m_Modules.push_back(std::move(module));
+        }
+        FlushLogsBeforeUnload();
+        libraryIt->second = std::move(library); //Unloads the previous version, its module is gone
+
+        if (m_IsConfigured)
+        {
+            reloaded->Configure();
+            OrderModules();
+        }
+        if (m_IsInitialized)
+            InitPendingModules();
+
+        LogInfo(LogHiveModule, "Reloaded module {}", std::string_view{name});
+        return true;
+    }
+
+    std::size_t ModuleRegistry::FindModule(std::string_view name) const
+    {
+        const auto it = std::find_if(m_Modules.begin(), m_Modules.end(),
+                                     [name](const auto &module) { return name == module->GetName(); });
+        return static_cast<std::size_t>(it - m_Modules.begin());
+    }
+
+    void ModuleRegistry::ShutdownWithDependents(std::size_t index)
+    {
+        //Dependents always come after their dependencies, one forward pass finds them all. Before ConfigureModules
+        //there is no graph yet, and nothing but the module itself is affected.
+        std::vector<bool> isAffected(m_Modules.size(), false);
+        isAffected[index] = true;
+        for (std::size_t i = index; i < m_InitGraph.dependents.size(); ++i)
+        {
+            if (!isAffected[i])
+                continue;
+
+            for (const std::size_t dependent : m_InitGraph.dependents[i])
+            {
+                isAffected[dependent] = true;
+            }
+        }
+
+        for (std::size_t i = m_Modules.size(); i-- > index;)
+        {
+            if (isAffected[i] && m_Modules[i]->IsInitialized())
+            {
+                m_ModuleShutdown.Broadcast(*m_Modules[i]);
+                m_Modules[i]->Shutdown();
+            }
+        }
+    }
+
+    void ModuleRegistry::FlushLogsBeforeUnload() const
+    {
+        //Queued records still point to categories, locations and formats in the library image
+        if (LogManager *logManager = TryGetService<LogManager>())
+            logManager->Flush();
+    }
+
+    void ModuleRegistry::InitPendingModules()
+    {
+        for (const auto &module : m_Modules)
+        {
+            if (module->IsInitialized())
+                continue;
+
+            module->Initialize();
+            m_ModuleInitialized.Broadcast(*module);
+        }
+    }
+
+    ModuleRegistry::ModuleLibrary::~ModuleLibrary()
+    {
+        library.Close();
+
+        std::error_code error;
+        std::filesystem::remove(loadedPath, error);
+    }
+
+    std::unique_ptr<ModuleRegistry::ModuleLibrary> ModuleRegistry::OpenModuleLibrary(const char *path,
+                                                                                      unsigned int generation)
+    {
+        auto library = std::make_unique<ModuleLibrary>();
+        library->path = path;
+        library->generation = generation;
+
+        //Loads a copy: Windows locks loaded files, and the loader may hand back the old image for the same path
+        library->loadedPath = library->path + "." + std::to_string(generation) + ".loaded";
+        std::error_code error;
+        std::filesystem::copy_file(library->path, library->loadedPath,
+                                   std::filesystem::copy_options::overwrite_existing, error);
+        if (error)
+        {
+            LogError(LogHiveModule, "Could not copy module library {}: {}", path, std::string_view{error.message()});
+            return nullptr;
+        }
+
+        if (!library->library.Open(library->loadedPath.c_str()))
+        {
+            LogError(LogHiveModule, "Could not load module library {}: {}", path,
+                     std::string_view{library->library.GetError()});
+            return nullptr;
+        }
+
+        using GetEntryFn = const ModuleLibraryEntry *(*)();
+        const auto getEntry = reinterpret_cast<GetEntryFn>(library->library.FindSymbol(ModuleLibraryEntrySymbol));
+        const ModuleLibraryEntry *entry = getEntry ? getEntry() : nullptr;
+        if (entry == nullptr)
+        {
+            LogError(LogHiveModule, "{} does not export {}", path, ModuleLibraryEntrySymbol);
+            return nullptr;
+        }
+
+        if (entry->abiVersion != ModuleLibraryAbiVersion || entry->moduleSize != sizeof(Module))
+        {
+            LogError(LogHiveModule, "{} was built against another version of Hive (module ABI {}, expected {})",
+                     path, entry->abiVersion, ModuleLibraryAbiVersion);
+            return nullptr;
+        }
+
+        library->create = entry->create;
+        return library;
     }
 }
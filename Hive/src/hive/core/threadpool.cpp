@@ -0,0 +1,63 @@
+#include <hive/precomp.h>
+#include <hive/core/threadpool.h>
+
+namespace hive
+{
+    ThreadPool::ThreadPool(unsigned int threadCount)
+    {
+        if (threadCount == 0)
+        {
+            const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+            threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        m_Threads.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; ++i)
+        {
+            m_Threads.emplace_back(&ThreadPool::WorkerMain, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_IsStopping = true;
+        }
+        m_TaskAvailable.notify_all();
+
+        for (std::thread &thread : m_Threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::Submit(Task task)
+    {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Tasks.push_back(std::move(task));
+        }
+        m_TaskAvailable.notify_one();
+    }
+
+    void ThreadPool::WorkerMain()
+    {
+        while (true)
+        {
+            Task task;
+            {
+                std::unique_lock lock(m_Mutex);
+                m_TaskAvailable.wait(lock, [this] { return m_IsStopping || !m_Tasks.empty(); });
+
+                if (m_Tasks.empty())
+                    return;
+
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+}
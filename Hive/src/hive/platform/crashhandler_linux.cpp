@@ -0,0 +1,93 @@
+#include <hive/precomp.h>
+#include <hive/platform/crashhandler.h>
+
+#include <atomic>
+#include <csignal>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace hive
+{
+    namespace
+    {
+        constexpr std::array<int, 5> CrashSignals = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+
+        std::atomic<CrashCallback> g_Callback{nullptr};
+        struct sigaction g_PreviousActions[CrashSignals.size()];
+
+        //Lets the handler run when the crash is a stack overflow on the installing thread
+        alignas(16) char g_AlternateStack[64 * 1024];
+
+        void RestorePreviousHandlers()
+        {
+            for (std::size_t i = 0; i < CrashSignals.size(); ++i)
+            {
+                sigaction(CrashSignals[i], &g_PreviousActions[i], nullptr);
+            }
+        }
+
+        void HandleCrashSignal(int signal)
+        {
+            const CrashCallback callback = g_Callback.exchange(nullptr);
+            RestorePreviousHandlers();
+
+            if (callback != nullptr)
+                callback(signal);
+
+            raise(signal);
+        }
+    }
+
+    bool InstallCrashHandler(CrashCallback callback)
+    {
+        if (g_Callback.exchange(callback) != nullptr)
+            return true;
+
+        stack_t alternateStack{};
+        alternateStack.ss_sp = g_AlternateStack;
+        alternateStack.ss_size = sizeof(g_AlternateStack);
+        sigaltstack(&alternateStack, nullptr);
+
+        struct sigaction action{};
+        action.sa_handler = HandleCrashSignal;
+        action.sa_flags = SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+
+        bool isInstalled = true;
+        for (std::size_t i = 0; i < CrashSignals.size(); ++i)
+        {
+            isInstalled &= sigaction(CrashSignals[i], &action, &g_PreviousActions[i]) == 0;
+        }
+        return isInstalled;
+    }
+
+    void RemoveCrashHandler()
+    {
+        if (g_Callback.exchange(nullptr) != nullptr)
+            RestorePreviousHandlers();
+    }
+
+    int CrashOutput::Open(const char *path)
+    {
+        return open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+
+    void CrashOutput::Write(int handle, const char *data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t written = write(handle, data, size);
+            if (written <= 0)
+                return;
+
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    void CrashOutput::Close(int handle)
+    {
+        close(handle);
+    }
+}
@@ -0,0 +1,84 @@
+#include <hive/precomp.h>
+#include <hive/platform/crashhandler.h>
+
+#include <atomic>
+#include <csignal>
+
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace hive
+{
+    namespace
+    {
+        std::atomic<CrashCallback> g_Callback{nullptr};
+        LPTOP_LEVEL_EXCEPTION_FILTER g_PreviousFilter{nullptr};
+        void (*g_PreviousAbortHandler)(int){SIG_DFL};
+
+        void RunCallback(int signal)
+        {
+            const CrashCallback callback = g_Callback.exchange(nullptr);
+            if (callback != nullptr)
+                callback(signal);
+        }
+
+        LONG WINAPI HandleUnhandledException(EXCEPTION_POINTERS *exception)
+        {
+            RunCallback(SIGSEGV);
+            return g_PreviousFilter ? g_PreviousFilter(exception) : EXCEPTION_CONTINUE_SEARCH;
+        }
+
+        void HandleAbort(int signal)
+        {
+            RunCallback(signal);
+            std::signal(SIGABRT, g_PreviousAbortHandler);
+            std::raise(signal);
+        }
+    }
+
+    bool InstallCrashHandler(CrashCallback callback)
+    {
+        if (g_Callback.exchange(callback) != nullptr)
+            return true;
+
+        g_PreviousFilter = SetUnhandledExceptionFilter(HandleUnhandledException);
+        g_PreviousAbortHandler = std::signal(SIGABRT, HandleAbort);
+        return true;
+    }
+
+    void RemoveCrashHandler()
+    {
+        if (g_Callback.exchange(nullptr) == nullptr)
+            return;
+
+        SetUnhandledExceptionFilter(g_PreviousFilter);
+        std::signal(SIGABRT, g_PreviousAbortHandler);
+    }
+
+    int CrashOutput::Open(const char *path)
+    {
+        return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    }
+
+    void CrashOutput::Write(int handle, const char *data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const int written = _write(handle, data, static_cast<unsigned int>(size));
+            if (written <= 0)
+                return;
+
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    void CrashOutput::Close(int handle)
+    {
+        _close(handle);
+    }
+}
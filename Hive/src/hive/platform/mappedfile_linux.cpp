@@ -0,0 +1,59 @@
+#include <hive/precomp.h>
+#include <hive/platform/mappedfile.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace hive
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(const char *path, std::size_t size)
+    {
+        Close();
+
+        m_FileDescriptor = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (m_FileDescriptor < 0)
+            return false;
+
+        if (ftruncate(m_FileDescriptor, static_cast<off_t>(size)) != 0)
+        {
+            close(m_FileDescriptor);
+            m_FileDescriptor = -1;
+            return false;
+        }
+
+        void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_FileDescriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            close(m_FileDescriptor);
+            m_FileDescriptor = -1;
+            return false;
+        }
+
+        m_Data = static_cast<std::byte *>(data);
+        m_Size = size;
+        return true;
+    }
+
+    void MappedFile::Close(std::size_t usedSize)
+    {
+        if (m_Data == nullptr)
+            return;
+
+        munmap(m_Data, m_Size);
+        if (ftruncate(m_FileDescriptor, static_cast<off_t>(usedSize < m_Size ? usedSize : m_Size)) != 0)
+        {
+            //The file keeps its zero filled tail, which readers skip
+        }
+        close(m_FileDescriptor);
+
+        m_Data = nullptr;
+        m_Size = 0;
+        m_FileDescriptor = -1;
+    }
+}
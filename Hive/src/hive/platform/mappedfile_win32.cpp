@@ -0,0 +1,66 @@
+#include <hive/precomp.h>
+#include <hive/platform/mappedfile.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace hive
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(const char *path, std::size_t size)
+    {
+        Close();
+
+        HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        const auto size64 = static_cast<unsigned long long>(size);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32),
+                                            static_cast<DWORD>(size64 & 0xFFFFFFFF), nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void *data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (data == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_Data = static_cast<std::byte *>(data);
+        m_Size = size;
+        m_FileHandle = file;
+        m_MappingHandle = mapping;
+        return true;
+    }
+
+    void MappedFile::Close(std::size_t usedSize)
+    {
+        if (m_Data == nullptr)
+            return;
+
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_MappingHandle);
+
+        LARGE_INTEGER end{};
+        end.QuadPart = static_cast<LONGLONG>(usedSize < m_Size ? usedSize : m_Size);
+        if (SetFilePointerEx(m_FileHandle, end, nullptr, FILE_BEGIN))
+            SetEndOfFile(m_FileHandle);
+        CloseHandle(m_FileHandle);
+
+        m_Data = nullptr;
+        m_Size = 0;
+        m_FileHandle = nullptr;
+        m_MappingHandle = nullptr;
+    }
+}
@@ -0,0 +1,50 @@
+#include <hive/precomp.h>
+#include <hive/platform/sharedlibrary.h>
+
+#include <dlfcn.h>
+
+namespace hive
+{
+    SharedLibrary::~SharedLibrary()
+    {
+        Close();
+    }
+
+    bool SharedLibrary::Open(const char *path)
+    {
+        Close();
+
+        //RTLD_LOCAL keeps the symbols of one version from being bound by the next one
+        m_Handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        if (m_Handle == nullptr)
+        {
+            const char *error = dlerror();
+            m_Error = error ? error : "dlopen failed";
+            return false;
+        }
+        return true;
+    }
+
+    void SharedLibrary::Close()
+    {
+        if (m_Handle)
+            dlclose(m_Handle);
+
+        m_Handle = nullptr;
+    }
+
+    void *SharedLibrary::FindSymbol(const char *name) const
+    {
+        if (m_Handle == nullptr)
+            return nullptr;
+
+        dlerror();
+        void *symbol = dlsym(m_Handle, name);
+        if (symbol == nullptr)
+        {
+            const char *error = dlerror();
+            m_Error = error ? error : "symbol not found";
+        }
+        return symbol;
+    }
+}
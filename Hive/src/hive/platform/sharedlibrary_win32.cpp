@@ -0,0 +1,53 @@
+#include <hive/precomp.h>
+#include <hive/platform/sharedlibrary.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace hive
+{
+    namespace
+    {
+        std::string GetLastErrorMessage(const char *operation)
+        {
+            return std::string{operation} + " failed with error " + std::to_string(GetLastError());
+        }
+    }
+
+    SharedLibrary::~SharedLibrary()
+    {
+        Close();
+    }
+
+    bool SharedLibrary::Open(const char *path)
+    {
+        Close();
+
+        m_Handle = LoadLibraryA(path);
+        if (m_Handle == nullptr)
+        {
+            m_Error = GetLastErrorMessage("LoadLibrary");
+            return false;
+        }
+        return true;
+    }
+
+    void SharedLibrary::Close()
+    {
+        if (m_Handle)
+            FreeLibrary(static_cast<HMODULE>(m_Handle));
+
+        m_Handle = nullptr;
+    }
+
+    void *SharedLibrary::FindSymbol(const char *name) const
+    {
+        if (m_Handle == nullptr)
+            return nullptr;
+
+        void *symbol = reinterpret_cast<void *>(GetProcAddress(static_cast<HMODULE>(m_Handle), name));
+        if (symbol == nullptr)
+            m_Error = GetLastErrorMessage("GetProcAddress");
+        return symbol;
+    }
+}
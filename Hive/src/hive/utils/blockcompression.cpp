@@ -0,0 +1,184 @@
+#include <hive/precomp.h>
+#include <hive/utils/blockcompression.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace hive
+{
+    namespace
+    {
+        constexpr std::size_t MinMatch = 4;
+        constexpr std::size_t LastLiterals = 5; //The format ends every block with at least this many literals
+        constexpr std::size_t MatchSearchLimit = 12; //No match may start in the last bytes of a block
+        constexpr std::size_t MaxOffset = 65535;
+        constexpr unsigned int HashBits = 12;
+
+        std::uint32_t Read32(const std::byte *data)
+        {
+            std::uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        std::uint32_t Hash(std::uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HashBits);
+        }
+
+        std::byte *WriteLength(std::byte *out, std::size_t length)
+        {
+            while (length >= 255)
+            {
+                *out++ = std::byte{255};
+                length -= 255;
+            }
+            *out++ = static_cast<std::byte>(length);
+            return out;
+        }
+
+        std::byte *WriteSequence(std::byte *out, const std::byte *literals, std::size_t literalLength,
+                                 std::size_t offset, std::size_t matchLength)
+        {
+            std::byte *token = out++;
+            const std::size_t matchCode = matchLength - MinMatch;
+
+            *token = static_cast<std::byte>((literalLength < 15 ? literalLength : 15) << 4);
+            if (literalLength >= 15)
+                out = WriteLength(out, literalLength - 15);
+
+            std::memcpy(out, literals, literalLength);
+            out += literalLength;
+
+            if (matchLength == 0)
+                return out;
+
+            *out++ = static_cast<std::byte>(offset & 0xFF);
+            *out++ = static_cast<std::byte>(offset >> 8);
+
+            *token |= static_cast<std::byte>(matchCode < 15 ? matchCode : 15);
+            if (matchCode >= 15)
+                out = WriteLength(out, matchCode - 15);
+
+            return out;
+        }
+
+        bool ReadLength(const std::byte *&in, const std::byte *end, std::size_t &length)
+        {
+            std::byte value;
+            do
+            {
+                if (in >= end)
+                    return false;
+                value = *in++;
+                length += static_cast<std::size_t>(value);
+            }
+            while (value == std::byte{255});
+            return true;
+        }
+    }
+
+    std::size_t CompressBlock(const std::byte *source, std::size_t size, std::byte *destination,
+                              std::size_t capacity)
+    {
+        if (capacity < GetCompressBound(size))
+            return 0;
+
+        std::byte *out = destination;
+        std::size_t anchor = 0;
+
+        if (size > MatchSearchLimit)
+        {
+            std::uint32_t table[1 << HashBits]{};
+            const std::size_t searchEnd = size - MatchSearchLimit;
+            const std::size_t matchEnd = size - LastLiterals;
+
+            std::size_t position = 0;
+            unsigned int misses = 0;
+            while (position < searchEnd)
+            {
+                const std::uint32_t sequence = Read32(source + position);
+                const std::uint32_t hash = Hash(sequence);
+                const std::size_t candidate = table[hash];
+                table[hash] = static_cast<std::uint32_t>(position);
+
+                if (candidate >= position || position - candidate > MaxOffset || Read32(source + candidate) != sequence)
+                {
+                    //Skip faster through data that does not compress
+                    position += 1 + (misses++ >> 6);
+                    continue;
+                }
+
+                std::size_t length = MinMatch;
+                while (position + length < matchEnd && source[candidate + length] == source[position + length])
+                {
+                    length++;
+                }
+
+                out = WriteSequence(out, source + anchor, position - anchor, position - candidate, length);
+                position += length;
+                anchor = position;
+                misses = 0;
+            }
+        }
+
+        out = WriteSequence(out, source + anchor, size - anchor, 0, 0);
+        return static_cast<std::size_t>(out - destination);
+    }
+
+    std::size_t DecompressBlock(const std::byte *source, std::size_t size, std::byte *destination,
+                                std::size_t capacity)
+    {
+        const std::byte *in = source;
+        const std::byte *const inEnd = source + size;
+        std::byte *out = destination;
+        std::byte *const outEnd = destination + capacity;
+
+        while (in < inEnd)
+        {
+            const auto token = static_cast<std::size_t>(*in++);
+
+            std::size_t literalLength = token >> 4;
+            if (literalLength == 15 && !ReadLength(in, inEnd, literalLength))
+                return 0;
+
+            if (literalLength > static_cast<std::size_t>(inEnd - in) ||
+                literalLength > static_cast<std::size_t>(outEnd - out))
+                return 0;
+
+            std::memcpy(out, in, literalLength);
+            in += literalLength;
+            out += literalLength;
+
+            //The last sequence only has literals
+            if (in == inEnd)
+                break;
+
+            if (inEnd - in < 2)
+                return 0;
+
+            const std::size_t offset = static_cast<std::size_t>(in[0]) | static_cast<std::size_t>(in[1]) << 8;
+            in += 2;
+            if (offset == 0 || offset > static_cast<std::size_t>(out - destination))
+                return 0;
+
+            std::size_t matchLength = token & 0xF;
+            if (matchLength == 15 && !ReadLength(in, inEnd, matchLength))
+                return 0;
+            matchLength += MinMatch;
+
+            if (matchLength > static_cast<std::size_t>(outEnd - out))
+                return 0;
+
+            //Byte by byte, the match may overlap what it produces
+            const std::byte *match = out - offset;
+            for (std::size_t i = 0; i < matchLength; ++i)
+            {
+                out[i] = match[i];
+            }
+            out += matchLength;
+        }
+
+        return static_cast<std::size_t>(out - destination);
+    }
+}
@@ -0,0 +1,21 @@
+#include <hive/precomp.h>
+#include <hive/utils/serviceregistry.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace hive
+{
+    //Not logged, the LogManager itself is a service and may be the missing one
+    void detail::ReportMissingService(const char *function)
+    {
+        std::fprintf(stderr, "Service used before it was provided: %s\n", function);
+        std::abort();
+    }
+
+    void detail::ReportDuplicateService(const char *function)
+    {
+        std::fprintf(stderr, "Service provided twice: %s\n", function);
+        std::abort();
+    }
+}
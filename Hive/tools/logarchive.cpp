@@ -0,0 +1,168 @@
+#include <hive/precomp.h>
+#include <hive/core/archivelogger.h>
+#include <hive/utils/blockcompression.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Prints the lines of hive::ArchiveLogger segments, optionally restricted to a time range.
+// Usage: hive_logarchive [--from <unix seconds>] [--to <unix seconds>] <segment.hla>...
+// The block index (.hli next to the segment) is used to only read and decompress the blocks overlapping the range;
+// without it the block headers are scanned instead.
+namespace
+{
+    using Header = hive::ArchiveLogger::BlockHeader;
+    using IndexEntry = hive::ArchiveLogger::IndexEntry;
+
+    struct TimeRange
+    {
+        std::uint64_t from{0};
+        std::uint64_t to{~std::uint64_t{0}};
+
+        [[nodiscard]] bool Overlaps(std::uint64_t first, std::uint64_t last) const { return first <= to && last >= from; }
+        [[nodiscard]] bool Contains(std::uint64_t timestamp) const { return timestamp >= from && timestamp <= to; }
+    };
+
+    std::uint64_t ParseSeconds(const char *text)
+    {
+        return static_cast<std::uint64_t>(std::strtod(text, nullptr) * 1e9);
+    }
+
+    // Lines start with "[<seconds>.<nanoseconds>]"
+    std::uint64_t ParseLineTimestamp(std::string_view line)
+    {
+        std::uint64_t seconds = 0;
+        std::uint64_t nanoseconds = 0;
+        std::size_t i = 1;
+        for (; i < line.size() && line[i] != '.'; ++i)
+            seconds = seconds * 10 + static_cast<std::uint64_t>(line[i] - '0');
+        for (++i; i < line.size() && line[i] != ']'; ++i)
+            nanoseconds = nanoseconds * 10 + static_cast<std::uint64_t>(line[i] - '0');
+        return seconds * 1000000000 + nanoseconds;
+    }
+
+    std::vector<IndexEntry> ReadIndex(const std::string &segmentPath)
+    {
+        std::vector<IndexEntry> entries;
+
+        const std::string indexPath = segmentPath.substr(0, segmentPath.find_last_of('.')) + ".hli";
+        std::FILE *file = std::fopen(indexPath.c_str(), "rb");
+        if (file == nullptr)
+            return entries;
+
+        IndexEntry entry;
+        while (std::fread(&entry, sizeof(entry), 1, file) == 1)
+        {
+            entries.push_back(entry);
+        }
+        std::fclose(file);
+        return entries;
+    }
+
+    std::vector<IndexEntry> ScanHeaders(std::FILE *segment)
+    {
+        std::vector<IndexEntry> entries;
+
+        Header header;
+        std::uint64_t offset = 0;
+        while (std::fseek(segment, static_cast<long>(offset), SEEK_SET) == 0 &&
+               std::fread(&header, sizeof(header), 1, segment) == 1 && header.magic == hive::ArchiveLogger::BlockMagic)
+        {
+            entries.push_back({header.firstTimestamp, header.lastTimestamp, offset});
+            offset += sizeof(header) + header.compressedSize;
+        }
+        return entries;
+    }
+
+    bool PrintBlock(std::FILE *segment, const IndexEntry &entry, const TimeRange &range, std::vector<std::byte> &raw,
+                    std::vector<std::byte> &compressed)
+    {
+        Header header;
+        if (std::fseek(segment, static_cast<long>(entry.offset), SEEK_SET) != 0 ||
+            std::fread(&header, sizeof(header), 1, segment) != 1 || header.magic != hive::ArchiveLogger::BlockMagic)
+            return false;
+
+        compressed.resize(header.compressedSize);
+        raw.resize(header.rawSize);
+        if (std::fread(compressed.data(), compressed.size(), 1, segment) != 1 ||
+            hive::DecompressBlock(compressed.data(), compressed.size(), raw.data(), raw.size()) != raw.size())
+            return false;
+
+        const bool isWholeBlock = range.Contains(header.firstTimestamp) && range.Contains(header.lastTimestamp);
+        std::string_view text{reinterpret_cast<const char *>(raw.data()), raw.size()};
+        while (!text.empty())
+        {
+            const std::size_t end = text.find('\n');
+            const std::string_view line = text.substr(0, end == std::string_view::npos ? text.size() : end + 1);
+            text.remove_prefix(line.size());
+
+            if (isWholeBlock || range.Contains(ParseLineTimestamp(line)))
+                std::fwrite(line.data(), line.size(), 1, stdout);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    TimeRange range;
+    std::vector<std::string> segments;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+        if (argument == "--from" && i + 1 < argc)
+            range.from = ParseSeconds(argv[++i]);
+        else if (argument == "--to" && i + 1 < argc)
+            range.to = ParseSeconds(argv[++i]);
+        else
+            segments.emplace_back(argument);
+    }
+
+    if (segments.empty())
+    {
+        std::fprintf(stderr, "usage: %s [--from <unix seconds>] [--to <unix seconds>] <segment.hla>...\n", argv[0]);
+        return 1;
+    }
+
+    int result = 0;
+    std::vector<std::byte> raw;
+    std::vector<std::byte> compressed;
+
+    for (const std::string &path : segments)
+    {
+        std::FILE *segment = std::fopen(path.c_str(), "rb");
+        if (segment == nullptr)
+        {
+            std::fprintf(stderr, "cannot open %s\n", path.c_str());
+            result = 1;
+            continue;
+        }
+
+        std::vector<IndexEntry> entries = ReadIndex(path);
+        if (entries.empty())
+            entries = ScanHeaders(segment);
+
+        for (const IndexEntry &entry : entries)
+        {
+            if (!range.Overlaps(entry.firstTimestamp, entry.lastTimestamp))
+                continue;
+
+            if (!PrintBlock(segment, entry, range, raw, compressed))
+            {
+                std::fprintf(stderr, "%s: corrupted block at offset %llu\n", path.c_str(),
+                             static_cast<unsigned long long>(entry.offset));
+                result = 1;
+                break;
+            }
+        }
+
+        std::fclose(segment);
+    }
+
+    return result;
+}
@@ -0,0 +1,141 @@
+#include <hive/precomp.h>
+#include <hive/core/logdeferred.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+// Offline formatter for files written by hive::BinaryLogFile
+// Usage: hive_logdecode <file.hlog>
+namespace
+{
+    class Reader
+    {
+    public:
+        explicit Reader(std::vector<char> data) : m_Data(std::move(data))
+        {
+        }
+
+        template<typename T>
+        bool Read(T &value)
+        {
+            if (m_Offset + sizeof(T) > m_Data.size())
+                return false;
+
+            std::memcpy(&value, m_Data.data() + m_Offset, sizeof(T));
+            m_Offset += sizeof(T);
+            return true;
+        }
+
+        const char *ReadBytes(std::size_t size)
+        {
+            if (m_Offset + size > m_Data.size())
+                return nullptr;
+
+            const char *bytes = m_Data.data() + m_Offset;
+            m_Offset += size;
+            return bytes;
+        }
+
+    private:
+        std::vector<char> m_Data;
+        std::size_t m_Offset{0};
+    };
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <binary log file>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    Reader reader{std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>())};
+
+    const char *magic = reader.ReadBytes(sizeof(hive::BinaryLogFile::Magic));
+    if (magic == nullptr || std::memcmp(magic, hive::BinaryLogFile::Magic, sizeof(hive::BinaryLogFile::Magic)) != 0)
+    {
+        std::fprintf(stderr, "%s is not a hive binary log\n", argv[1]);
+        return 1;
+    }
+
+    std::unordered_map<std::uint64_t, std::string> formats;
+    std::unordered_map<std::uint64_t, std::string> categories;
+    std::vector<std::byte> args;
+    hive::LogFormatBuffer message;
+
+    hive::BinaryLogFile::Tag tag;
+    while (reader.Read(tag))
+    {
+        switch (tag)
+        {
+            case hive::BinaryLogFile::Tag::FORMAT:
+            case hive::BinaryLogFile::Tag::CATEGORY:
+            {
+                std::uint64_t id;
+                std::uint32_t size;
+                const char *text = nullptr;
+                if (!reader.Read(id) || !reader.Read(size) || (text = reader.ReadBytes(size)) == nullptr)
+                {
+                    std::fprintf(stderr, "truncated %s record\n", tag == hive::BinaryLogFile::Tag::FORMAT ? "format" : "category");
+                    return 1;
+                }
+
+                auto &dictionary = tag == hive::BinaryLogFile::Tag::FORMAT ? formats : categories;
+                dictionary[id] = std::string(text, size);
+                break;
+            }
+            case hive::BinaryLogFile::Tag::MESSAGE:
+            {
+                std::uint64_t timestamp, categoryId, formatId;
+                std::uint8_t severity, argCount;
+                std::uint32_t argSize;
+                if (!reader.Read(timestamp) || !reader.Read(severity) || !reader.Read(categoryId) ||
+                    !reader.Read(formatId) || !reader.Read(argCount) || !reader.Read(argSize))
+                {
+                    std::fprintf(stderr, "truncated message record\n");
+                    return 1;
+                }
+
+                const char *argBytes = reader.ReadBytes(argSize);
+                if (argBytes == nullptr)
+                {
+                    std::fprintf(stderr, "truncated message record at %" PRIu64 "\n", timestamp);
+                    return 1;
+                }
+
+                args.resize(argSize);
+                std::memcpy(args.data(), argBytes, argSize);
+
+                if (severity > static_cast<std::uint8_t>(hive::LogSeverity::ERROR) ||
+                    !hive::IsValidDeferredArgs(args.data(), args.size(), argCount))
+                {
+                    std::fprintf(stderr, "skipping malformed record at %" PRIu64 "\n", timestamp);
+                    break;
+                }
+
+                message.Clear();
+                hive::FormatDeferredMessage(message, formats[formatId], args.data(), argCount);
+
+                std::printf("[%" PRIu64 ".%09" PRIu64 "] [%s] %s - %s\n", timestamp / 1000000000, timestamp % 1000000000,
+                            hive::GetSeverityName(static_cast<hive::LogSeverity>(severity)),
+                            categories[categoryId].c_str(), message.CStr());
+                break;
+            }
+            default:
+                std::fprintf(stderr, "corrupted record\n");
+                return 1;
+        }
+    }
+
+    return 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <hive/core/module.h>
 #include <hive/core/log.h>
+#include <hive/utils/serviceregistry.h>
 class SystemModule : public hive::Module
 {
 public:
@@ -16,5 +17,6 @@ protected:
 private:
     hive::LogManager m_LogManager;
     hive::ConsoleLogger m_Logger;
+    hive::ServiceScope m_Services; //Last, so the services are withdrawn before they are destroyed
 };
 
@@ -3,4 +3,4 @@
 
 #include <hive/core/log.h>
 
-const hive::LogCategory LogTestbedRoot { "Testbed" };
\ No newline at end of file
+constinit const hive::LogCategory LogTestbedRoot { "Testbed" };
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include <terra/window/window.h>
 
 
+#include <chrono>
 #include <iostream>
 struct Vertex
 {
@@ -128,12 +129,14 @@ void DestroyModel(RenderContext &context, Model& model);
 
 int main()
 {
-    hive::ModuleRegistry moduleRegistry;
+    hive::ServiceScope services;
+    hive::ModuleRegistry &moduleRegistry = services.Emplace<hive::ModuleRegistry>();
     RegisterSystemModule();
 
     moduleRegistry.CreateModules();
     moduleRegistry.ConfigureModules();
     moduleRegistry.InitModules();
+    moduleRegistry.LogTimingSummary();
 
     hive::LogInfo(hive::LogHiveRoot, "Hello from hive");
     hive::LogInfo(LogTestbedRoot, "Hello from testbed");
@@ -164,10 +167,15 @@ int main()
         swarm::RenderpassSetClearValue(renderContext.renderpass, clearValues);
 
         int frame = 0;
+        auto lastFrameTime = std::chrono::steady_clock::now();
         while (!window.ShouldClose())
         {
             terra::Window::PollEvents();
 
+            const auto frameTime = std::chrono::steady_clock::now();
+            moduleRegistry.TickModules(std::chrono::duration<double>(frameTime - lastFrameTime).count());
+            lastFrameTime = frameTime;
+
             swarm::CmdBeginFrameInfo beginFrameInfo{};
             beginFrameInfo.device = renderContext.device;
             beginFrameInfo.inFlightFence = renderContext.inFlightFences[frame];
@@ -196,6 +204,8 @@ int main()
             frame = (frame + 1) % 2;
         }
 
+        moduleRegistry.LogTickSummary();
+
         DestroyModel(renderContext, model);
         ShutdownScene(renderContext);
         ShutdownRenderContext(renderContext);
@@ -203,6 +213,7 @@ int main()
 
     terra::Window::BackendShutdown();
     moduleRegistry.ShutdownModules();
+    moduleRegistry.WriteTimingTrace("testbed_modules.json");
 }
 
 void InitRenderContext(RenderContext &context, terra::Window::NativeHandle handle)
@@ -1,11 +1,13 @@
 #include <testbed/precomp.h>
 #include <testbed/systemmodule.h>
 
+#include <hive/core/flightrecorder.h>
+#include <hive/core/logfilter.h>
 #include <hive/core/moduleregistry.h>
 
 void RegisterSystemModule()
 {
-    hive::ModuleRegistry::GetInstance().RegisterModule([]() -> std::unique_ptr<hive::Module>
+    hive::GetService<hive::ModuleRegistry>().RegisterModule([]() -> std::unique_ptr<hive::Module>
     {
         return std::make_unique<SystemModule>();
     });
@@ -13,14 +15,27 @@ void RegisterSystemModule()
 
 SystemModule::SystemModule() : m_Logger(m_LogManager)
 {
+    m_Services.Provide(m_LogManager);
 }
 
 void SystemModule::DoInitialize()
 {
     Module::DoInitialize();
+
+    //Optional per-category levels, see hive/core/logfilter.h for the format
+    hive::LoadLogConfig("log.cfg");
+
+    //Keep console I/O off the frame thread
+    m_LogManager.StartAsync();
+
+    //Trace history is kept in memory and only written out on a crash
+    m_LogManager.EnableFlightRecorder({});
 }
 
 void SystemModule::DoShutdown()
 {
+    m_LogManager.StopAsync();
+    m_LogManager.DisableFlightRecorder();
+
     Module::DoShutdown();
 }